@@ -0,0 +1,133 @@
+#include <string.h>
+#include "banker.h"
+
+// Decisão de um pedido ou liberação isolados, sem escrever nada: usada pela linha de comando (que escreve result.txt)
+// e pelo servidor (que responde ao cliente)
+
+static int isAdmissionSafe(const BankerState *state, SafetyEngine *engine, const SafetyOverlay *overlay);
+
+// Limites de um pedido RQ: não pode passar da NEED do cliente nem dos recursos disponíveis
+RequestDecision checkRequestLimits(const BankerState *state, int customerID, const int *request)
+{
+    const int *need = needRow(state, customerID);
+
+    // Checa se o recurso solicitado é maior que a necessidade restante do cliente
+    for (int i = 0; i < state->numberOfResources; i++)
+    {
+        if (request[i] > need[i])
+        {
+            return REQUEST_EXCEEDS_NEED;
+        }
+    }
+
+    // Checa se o recurso solicitado é maior que o recurso disponível
+    for (int i = 0; i < state->numberOfResources; i++)
+    {
+        if (request[i] > state->availableResources[i])
+        {
+            return REQUEST_NOT_AVAILABLE;
+        }
+    }
+    return REQUEST_GRANTED;
+}
+
+// Decide um pedido RQ: se for aceito fica aplicado no estado (e o motor é atualizado), senão o estado não muda
+// A segurança é checada com o motor se houver (com o pool dele no reparo), senão com checkSafety
+// O pedido é checado como um overlay (o estado mais a linha nova do cliente), então uma negação não escreve no estado
+RequestDecision admitRequest(BankerState *state, SafetyEngine *engine, int customerID, const int *request)
+{
+    int numberOfResources = state->numberOfResources;
+    int rowLength = state->rowStride;
+
+    STATS_COUNT(requests);
+    RequestDecision decision = checkRequestLimits(state, customerID, request);
+    if (decision != REQUEST_GRANTED)
+    {
+        STATS_DECISION(decision);
+        return decision;
+    }
+
+    // Disponíveis, alocação e NEED do cliente depois do pedido, com o padding zerado copiado das linhas do estado
+    int available[rowLength];
+    int allocation[rowLength];
+    int need[rowLength];
+    memcpy(available, state->availableResources, rowLength * sizeof(int));
+    memcpy(allocation, allocationRow(state, customerID), rowLength * sizeof(int));
+    memcpy(need, needRow(state, customerID), rowLength * sizeof(int));
+    for (int i = 0; i < numberOfResources; i++)
+    {
+        available[i] -= request[i];  // Subtrai os recursos solicitados dos recursos disponíveis
+        allocation[i] += request[i]; // Adiciona os recursos solicitados na alocação atual
+        need[i] -= request[i];       // Subtrai os recursos solicitados da necessidade restante
+    }
+
+    SafetyOverlay overlay = { customerID, available, allocation, need };
+    if (!isAdmissionSafe(state, engine, &overlay))
+    {
+        STATS_DECISION(REQUEST_UNSAFE);
+        return REQUEST_UNSAFE;
+    }
+
+    // Commit: só agora o estado muda
+    memcpy(state->availableResources, available, numberOfResources * sizeof(int));
+    memcpy(allocationRow(state, customerID), allocation, numberOfResources * sizeof(int));
+    memcpy(needRow(state, customerID), need, numberOfResources * sizeof(int));
+    if (engine)
+    {
+        safetyEngineUpdateCustomer(engine, state, customerID); // Reposiciona o cliente nas ordenações
+    }
+    STATS_DECISION(REQUEST_GRANTED);
+    return REQUEST_GRANTED;
+}
+
+// Decide uma liberação RL. Retorna 1 se foi aplicada, 0 se passa da alocação atual do cliente
+int admitRelease(BankerState *state, SafetyEngine *engine, int customerID, const int *release)
+{
+    int numberOfResources = state->numberOfResources;
+    int *allocation = allocationRow(state, customerID);
+    int *need = needRow(state, customerID);
+
+    STATS_COUNT(releases);
+    for (int i = 0; i < numberOfResources; i++)
+    {
+        if (release[i] > allocation[i])
+        {
+            STATS_COUNT(releasesDenied);
+            return 0;
+        }
+    }
+
+    for (int i = 0; i < numberOfResources; i++)
+    {
+        state->availableResources[i] += release[i]; // Recupera os recursos disponíveis
+        allocation[i] -= release[i];                // Recupera a alocação atual
+        need[i] += release[i];                      // Recupera a necessidade restante
+    }
+    if (engine)
+    {
+        // Devolver recursos não deixa inseguro um estado seguro: a sequência guardada continua valendo
+        // Um valor negativo, que na prática aloca mais, pode deixar, então a sequência é descartada
+        if (rowHasNegative(release, numberOfResources))
+        {
+            engine->hasSafeSequence = 0;
+        }
+        safetyEngineUpdateCustomer(engine, state, customerID); // A NEED do cliente aumentou, reposiciona nas ordenações
+    }
+    return 1;
+}
+
+static int isAdmissionSafe(const BankerState *state, SafetyEngine *engine, const SafetyOverlay *overlay)
+{
+    int safe;
+    STATS_TIMER_START(timer);
+    if (engine)
+    {
+        safe = safetyEngineCheckOverlay(engine, state, overlay);
+    }
+    else
+    {
+        safe = checkSafetyOverlay(state, overlay, NULL);
+    }
+    STATS_TIMER_STOP(timer);
+    return safe;
+}
@@ -1,539 +1,662 @@
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/types.h>
+#include <unistd.h>
+#include "banker.h"
+
+// Opções da linha de comando (vêm antes dos recursos)
+typedef struct
+{
+    int numberOfThreads;        // --threads N
+    int batchSize;              // --batch N: admite até N pedidos RQ consecutivos juntos
+    const char *replayBinary;   // --replay-binary FILE: lê os comandos de um trace binário em vez de commands.txt
+    const char *convertInput;   // --convert-trace IN OUT: converte commands.txt para o trace binário e termina
+    const char *convertOutput;
+    const char *serveSocket;    // --serve PATH: atende comandos num socket Unix em vez de ler commands.txt
+    const char *statsFile;      // --stats FILE: escreve as estatísticas em JSON na saída e a cada SIGUSR1 (make STATS=1)
+    int compact;                // --compact: guarda as matrizes em células de 8/16/32 bits (compact.c)
+    const char *checkpointFile; // --checkpoint FILE: onde os comandos CP (e --checkpoint-every) gravam o estado
+    long checkpointEvery;       // --checkpoint-every N: grava um checkpoint a cada N comandos
+    const char *restoreFile;    // --restore FILE: recomeça do checkpoint em vez de customer.txt e dos recursos
+    int pipeline;               // --pipeline: leitura, decisão e escrita de result.txt em três threads (pipeline.c)
+} BankerOptions;
 
 // Declaração das Funções
-int bankerAlgorithm(int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources);
-int checkSafety(int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources, int *safeSequence);
-void requestResources(int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources, int customerID, int *requestedResources, FILE *outputFile);
-void releaseResources(int **currentAllocation, int **remainingNeed, int *availableResources, int customerID, int numberOfResources, int *resourcesToRelease, FILE *outputFile);
-void printAllMatrices(FILE *filePointer, int rows, int cols);
-int readCustomerMaximumDemand(const char *filename, int numberOfCustomers, int numberOfResources);
-int processBankerCommands(const char *filename, int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources, FILE *outputFile);
-int countNumberOfCustomers(const char *filename);
-int countNumberOfResources(const char *filename);
-int** allocate2DMatrix(int rows, int cols);
-void free2DMatrix(int **matrix, int rows);
+void requestResources(Banker *banker, int customerID, int *requestedResources, OutputWriter *outputFile);
+void releaseResources(Banker *banker, int customerID, int *resourcesToRelease, OutputWriter *outputFile);
+int executeCommand(Banker *banker, const Command *command, OutputWriter *outputFile);
+int applyCommand(Banker *banker, const Command *command, OutputWriter *outputFile);
+int writeCheckpoint(Banker *banker, OutputWriter *outputFile);
+int executeCompactCommand(const Command *command, OutputWriter *outputFile);
+int queryGrantable(Banker *banker, const Command *command, OutputWriter *outputFile);
+void flushRequestBatch(Banker *banker, OutputWriter *outputFile);
+int processBankerCommands(const char *filename, int numberOfCustomers, int numberOfResources, OutputWriter *outputFile);
+int replayBinaryCommands(const char *filename, int numberOfCustomers, int numberOfResources, OutputWriter *outputFile);
+int parseOptions(int argc, char *argv[], BankerOptions *options);
+int serveBankerCommands(const char *socketPath, Banker *banker);
+void handleStopSignal(int signalNumber);
 
 // Variáveis Globais
-int **maximumDemand;     // Matriz de demanda máxima
-int **currentAllocation; // Matriz de alocação atual
-int **remainingNeed;     // Matriz de necessidade restante
-int cmdLineResources;    // Número de recursos passados na linha de comando
+Banker *bankerHandle;        // Estado, motor incremental (e pool de --threads N) da libbanker; NULL no modo --compact
+RequestBatch *requestBatch; // Lote de pedidos consecutivos (--batch N), NULL sem a opção
+BankerServer *bankerServer; // Servidor do modo --serve, parado por SIGINT/SIGTERM
+CompactState *compactState; // Estado do modo --compact, usado no lugar de bankerHandle
+const char *checkpointFile;         // --checkpoint FILE, NULL sem a opção
+unsigned long long checkpointEvery; // --checkpoint-every N (0: só nos comandos CP)
+unsigned long long commandSequence; // Comandos do arquivo já aplicados ao estado, contados desde o início do arquivo
+unsigned long long skipCommands;    // Comandos do início do arquivo que o checkpoint de --restore já inclui
+unsigned long long restoreOutputOffset; // Tamanho de result.txt com a saída desses comandos
+const char *commandError;           // Por que executeCommand retornou 0
 
 int main(int argc, char *argv[]) 
 {
-    // Verifica se o arquivo commands.txt pode ser aberto
-    FILE *testFile = fopen("commands.txt", "r");
-    if (!testFile) 
+    // Lê as opções que vêm antes dos recursos
+    BankerOptions options = { 1, 1, NULL, NULL, NULL, NULL, NULL, 0, NULL, 0, NULL, 0 };
+    int firstResource = parseOptions(argc, argv, &options);
+    if (firstResource < 0
+        || (options.compact && (options.numberOfThreads > 1 || options.batchSize > 1 || options.serveSocket || options.checkpointFile || options.restoreFile))
+        || (options.checkpointEvery > 0 && !options.checkpointFile) || (options.checkpointFile && options.serveSocket)
+        || (options.restoreFile && firstResource < argc)
+        || (options.pipeline && (options.batchSize > 1 || options.compact || options.serveSocket || options.checkpointFile || options.restoreFile)))
     {
-        printf("Fail to read commands.txt\n");
+        printf("Usage: ./banker [--threads N] [--batch N] [--replay-binary FILE] [--stats FILE] [--checkpoint FILE [--checkpoint-every N]] <resources...>\n");
+        printf("       ./banker [--threads N] [--batch N] [--replay-binary FILE] [--stats FILE] [--checkpoint FILE [--checkpoint-every N]] --restore FILE\n");
+        printf("       ./banker --pipeline [--threads N] [--replay-binary FILE] [--stats FILE] <resources...>\n");
+        printf("       ./banker --compact [--replay-binary FILE] [--stats FILE] <resources...>\n");
+        printf("       ./banker [--threads N] [--stats FILE] --serve <socket> <resources...>\n");
+        printf("       ./banker [--threads N] [--stats FILE] --restore FILE --serve <socket>\n");
+        printf("       ./banker --convert-trace <commands.txt> <trace.bin>\n");
         return 1;
     }
-    fclose(testFile);
 
-    // Verifica se o arquivo customer.txt pode ser aberto
-    testFile = fopen("customer.txt", "r");
-    if (!testFile) 
+    // Só converte o arquivo de comandos, sem executar nada
+    if (options.convertInput)
     {
-        printf("Fail to read customer.txt\n");
+        long records = convertTextTrace(options.convertInput, options.convertOutput);
+        if (records < 0)
+        {
+            return 1;
+        }
+        printf("Converted %ld commands to %s\n", records, options.convertOutput);
+        return 0;
+    }
+
+    // Estatísticas: só existem se o programa foi compilado com make STATS=1
+    if (options.statsFile)
+    {
+#ifdef BANKER_STATS
+        enableBankerStats(options.statsFile);
+#else
+        printf("Statistics are not compiled in (build with make STATS=1)\n");
         return 1;
+#endif
     }
-    fclose(testFile);
 
-    // Variaveis pra verificar o número de clientes e recursos da linha de comando
-    int numberOfResources = argc - 1;
-    cmdLineResources = argc - 1;
+    // Verifica se o arquivo de comandos pode ser aberto (no modo servidor os comandos vêm do socket)
+    const char *commandsFile = options.replayBinary ? options.replayBinary : "commands.txt";
+    FILE *testFile;
+    if (!options.serveSocket)
+    {
+        testFile = fopen(commandsFile, "r");
+        if (!testFile)
+        {
+            printf("Fail to read %s\n", commandsFile);
+            return 1;
+        }
+        fclose(testFile);
+    }
 
-    // Aloca memória para recursos disponíveis
-    int *availableResources = (int *)malloc(numberOfResources * sizeof(int));
+    // Recursos disponíveis da linha de comando
+    int numberOfResources = argc - firstResource;
+    int available[numberOfResources + 1];
     for (int i = 0; i < numberOfResources; i++) 
     {
-        availableResources[i] = atoi(argv[i + 1]);
+        available[i] = atoi(argv[firstResource + i]);
     }
 
-    // Obtém o número de clientes do arquivo customer.txt
-    int numberOfCustomers = countNumberOfCustomers("customer.txt");
+    // Com --restore, o estado vem do checkpoint (sem customer.txt) e os comandos que ele já inclui não são executados de novo
+    checkpointFile = options.checkpointFile;
+    checkpointEvery = options.checkpointEvery;
+    BankerState *state = NULL;
+    if (options.restoreFile)
+    {
+        const char *error = NULL;
+        state = loadCheckpoint(options.restoreFile, &commandSequence, &restoreOutputOffset, &error);
+        if (!state)
+        {
+            printf("%s: %s\n", options.restoreFile, error);
+            return 1;
+        }
+        skipCommands = commandSequence;
+        numberOfResources = state->numberOfResources;
+    }
 
-    int fileNumberOfResources = countNumberOfResources("customer.txt");
-    if (fileNumberOfResources != numberOfResources) 
+    // Lê customer.txt uma vez só: o número de clientes e o de recursos vêm do próprio arquivo e as demandas máximas vão
+    // direto para o estado (a alocação inicial é zero). Com --compact, para as células compactas, sem as matrizes int
+    CustomerFileStatus customerStatus = CUSTOMERS_LOADED;
+    if (options.compact)
     {
+        compactState = loadCompactState("customer.txt", numberOfResources, &customerStatus);
+    }
+    else if (!options.restoreFile)
+    {
+        state = loadCustomerFile("customer.txt", numberOfResources, &customerStatus);
+    }
+    switch (customerStatus)
+    {
+    case CUSTOMERS_LOADED:
+        break;
+    case CUSTOMERS_UNREADABLE:
+        printf("Fail to read customer.txt\n");
+        return 1;
+    case CUSTOMERS_WIDTH_MISMATCH:
         printf("Incompatibility between customer.txt and command line\n");
-        free(availableResources);
         return 1;
+    case CUSTOMERS_NO_MEMORY:
+        printf("Error: Unable to allocate the banker state\n");
+        return 1;
+    case CUSTOMERS_NEGATIVE:
+        printf("Fail to read customer.txt (--compact needs non-negative maximum demands)\n");
+        return 1;
+    case CUSTOMERS_MALFORMED:
+        printf("Fail to read customer.txt\n");
+        goto cleanup;
     }
 
-    // Alocando memória para as matrizes
-    currentAllocation = allocate2DMatrix(numberOfCustomers, numberOfResources); // Aloca a matriz de alocação atual
-    maximumDemand = allocate2DMatrix(numberOfCustomers, numberOfResources);     // Aloca a matriz de demanda máxima
-    remainingNeed = allocate2DMatrix(numberOfCustomers, numberOfResources);     // Aloca a matriz de necessidade restante
+    int numberOfCustomers;
+    if (compactState)
+    {
+        numberOfCustomers = compactState->numberOfCustomers;
+        setCompactAvailable(compactState, available);
+        goto commands;
+    }
+    numberOfCustomers = state->numberOfCustomers;
+    if (!options.restoreFile)
+    {
+        memcpy(state->availableResources, available, numberOfResources * sizeof(int));
+    }
 
-    // Lendo as demandas máximas dos clientes
-    if (!readCustomerMaximumDemand("customer.txt", numberOfCustomers, numberOfResources)) 
+    // O handle da libbanker fica com o estado. Com --threads, cada checagem divide as passadas entre as threads; senão usa
+    // o motor incremental, criado a partir da necessidade restante inicial
+    bankerHandle = adoptBankerState(state, options.numberOfThreads);
+    if (!bankerHandle)
     {
-        printf("Fail to read customer.txt\n");
+        destroyBankerState(state);
+        printf("Error: Unable to allocate the safety engine\n");
         goto cleanup;
     }
 
-    // Calcula a necessidade restante de cada cliente
-    for (int i = 0; i < numberOfCustomers; i++) 
+    // Modo servidor: as matrizes ficam na memória e os comandos chegam pelo socket até SIGINT/SIGTERM
+    if (options.serveSocket)
     {
-        for (int j = 0; j < numberOfResources; j++) 
+        serveBankerCommands(options.serveSocket, bankerHandle);
+        goto cleanup;
+    }
+
+    // Com --batch, os pedidos RQ consecutivos são acumulados e admitidos juntos
+    if (options.batchSize > 1)
+    {
+        requestBatch = createRequestBatch(options.batchSize, numberOfResources);
+        if (!requestBatch)
         {
-            remainingNeed[i][j] = maximumDemand[i][j] - currentAllocation[i][j]; // Necessidade restante = Demanda máxima - Alocação atual
+            printf("Error: Unable to allocate the request batch\n");
+            goto cleanup;
         }
     }
 
-    // Abre o arquivo de saída
-    FILE *outputFile = fopen("result.txt", "w");
+    // Abre o arquivo de saída (bufferizado, escrito em blocos grandes)
+    // Com --restore, o result.txt da execução anterior é mantido até o checkpoint e a saída continua dali
+commands:;
+    OutputWriter *outputFile = options.restoreFile ? openOutputWriterAt("result.txt", restoreOutputOffset) : openOutputWriter("result.txt");
+    if (!outputFile && options.restoreFile)
+    {
+        printf("Error: Unable to continue result.txt after the checkpoint (needs at least %llu bytes)\n", restoreOutputOffset);
+        goto cleanup;
+    }
     if (!outputFile) 
     {
         printf("Error: Unable to open result.txt for writing\n");
         goto cleanup;
     }
 
-    // Executa os comando do arquivo commands.txt
-    if (!processBankerCommands("commands.txt", currentAllocation, remainingNeed, availableResources, numberOfCustomers, numberOfResources, outputFile)) 
+    // Executa os comando do arquivo commands.txt (ou do trace binário); com --pipeline, em três threads com a mesma saída
+    int commandsOk;
+    if (options.pipeline)
     {
-        printf("Incompatibility between commands.txt and command line\n");
-        fclose(outputFile);
+        commandsOk = runCommandPipeline(commandsFile, options.replayBinary != NULL, getBankerState(bankerHandle),
+                                        getBankerEngine(bankerHandle), outputFile);
+    }
+    else
+    {
+        commandsOk = options.replayBinary ? replayBinaryCommands(commandsFile, numberOfCustomers, numberOfResources, outputFile)
+                                          : processBankerCommands(commandsFile, numberOfCustomers, numberOfResources, outputFile);
+    }
+    flushRequestBatch(bankerHandle, outputFile); // Decide os pedidos que ficaram no lote
+    if (!commandsOk)
+    {
+        printf("Incompatibility between %s and command line\n", commandsFile);
+        closeOutputWriter(outputFile);
         goto cleanup;
     }
 
-    // Fecha o arquivo
-    fclose(outputFile);
+    // Fecha o arquivo (descarrega o que ficou no buffer)
+    if (!closeOutputWriter(outputFile))
+    {
+        printf("Error: Unable to write result.txt\n");
+    }
 
     // Libera a memória alocada e termina o programa
 cleanup:
-    free2DMatrix(currentAllocation, numberOfCustomers);
-    free2DMatrix(maximumDemand, numberOfCustomers);
-    free2DMatrix(remainingNeed, numberOfCustomers);
-    free(availableResources);
+#ifdef BANKER_STATS
+    if (options.statsFile && !dumpBankerStats())
+    {
+        printf("Error: Unable to write %s\n", options.statsFile);
+    }
+#endif
+    destroyRequestBatch(requestBatch);
+    bankerDestroy(bankerHandle);
+    destroyCompactState(compactState);
     return 0;
 }
 
 
-// Lê a demanda máxima dos clientes do arquivo customer.txt
-int readCustomerMaximumDemand(const char *filename, int numberOfCustomers, int numberOfResources) 
+// Lê as opções da linha de comando e retorna o índice do primeiro recurso, ou -1 se alguma opção for inválida
+int parseOptions(int argc, char *argv[], BankerOptions *options)
 {
-    // Abre o arquivo
-    FILE *file = fopen(filename, "r");
-    if (!file)
-    {
-      return 0;  
-    } 
-
-    char line[100];          // Tamanho máximo de uma linha do arquivo
-    int currentCustomer = 0; // Rastreia o número de clientes processados
-
-    // Lê cada linha do arquivo até chegar no final do arquivo ou até processar o numero de clientes 
-    while (fgets(line, sizeof(line), file) != NULL && currentCustomer < numberOfCustomers) 
+    int i = 1;
+    while (i < argc && strncmp(argv[i], "--", 2) == 0)
     {
-        int maxRequests[numberOfResources]; // Vetor para armazenar a demanda máxima de cada cliente
-        char *token = strtok(line, ",");    // Divide a linha em tokens separados por vírgula
-
-        // Lê cada token e converte para inteiro
-        for (int i = 0; i < numberOfResources; i++) 
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
         {
-            // Se o token for nulo, o arquivo está mal formatado ou não tem o número de recursos esperado 
-            // || Se o número de recursos passados na linha de comando for maior que o número de recursos esperado
-            if (token == NULL || i >= cmdLineResources)
-            {
-                fclose(file);
-                return 0;
-            }
-            maxRequests[i] = atoi(token);                       // Converte o token para inteiro (O pedido máximo de um recurso para um cliente)
-            token = strtok(NULL, ",");                          // Pega o próximo token
-            maximumDemand[currentCustomer][i] = maxRequests[i]; // Armazena o pedido máximo de um recurso para um cliente
+            options->numberOfThreads = atoi(argv[i + 1]);
+            i += 2;
         }
-        currentCustomer++; // Incrementa o número de clientes processados, indicando que o cliente atual foi processado com sucesso
-    }
-
-    fclose(file);
-    return currentCustomer == numberOfCustomers; // Retorna 1 se o número de clientes processados for igual ao número de clientes esperados e 0 caso contrário
-}
-
-// Processa os comandos do arquivo commands.txt, lidando com a alocação e liberação de recursos baseado nos comandos presentes no arquivo
-int processBankerCommands(const char *filename, int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources, FILE *outputFile) 
-{
-    FILE *file = fopen(filename, "r");
-    if (!file)
-    {
-        return 0;
-    }
-
-    char *line = NULL;         // Inicializa line como NULL
-    size_t len = 0;            // Tamanho da linha
-    ssize_t read;              // Número de caracteres lidos
-
-    while ((read = getline(&line, &len, file)) != -1) // Lê cada linha do arquivo
-    {
-        char command[3];                  // Guarda o comando a ser executado (RQ ou RL)
-        int customerID;                   // Guarda o ID do cliente a ser alocado ou liberado
-        int resources[numberOfResources]; // Guarda os recursos a serem alocados ou liberados
-
-        // Se a linha for igual a *, imprime as matrizes e os recursos disponíveis
-        if (strcmp(line, "*\n") == 0 || strcmp(line, "*") == 0)     
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
         {
-            printAllMatrices(outputFile, numberOfCustomers, numberOfResources); // Imprime as matrizes no arquivo
-            fprintf(outputFile, "AVAILABLE ");                                  
-            for (int i = 0; i < numberOfResources; i++) // Imprime os recursos disponíveis no arquivo
-            {
-                fprintf(outputFile, "%d ", availableResources[i]);
-            }
-            fprintf(outputFile, "\n");
-            continue;
+            options->batchSize = atoi(argv[i + 1]);
+            i += 2;
         }
-
-        if (sscanf(line, "%2s %d", command, &customerID) < 2) // Lê o comando e o ID do cliente, se não conseguir, o arquivo está mal formatado
+        else if (strcmp(argv[i], "--replay-binary") == 0 && i + 1 < argc)
         {
-            fclose(file);
-            free(line);
-            return 0;
+            options->replayBinary = argv[i + 1];
+            i += 2;
         }
-
-        char *token = strtok(line, " "); // Divide a linha em tokens separados por espaço
-        token = strtok(NULL, " ");       // Pula o token do comando
-        token = strtok(NULL, " ");       // Pula o token do customerID
-
-        // Lê os recursos a serem alocados ou liberados
-        for (int i = 0; i < numberOfResources && token != NULL; i++) 
+        else if (strcmp(argv[i], "--convert-trace") == 0 && i + 2 < argc)
         {
-            if (i >= cmdLineResources) // Se o número de recursos passados na linha de comando for maior que o número de recursos esperado
-            {
-                fclose(file);
-                free(line);
-                return 0;
-            }
-            resources[i] = atoi(token); // E guarda no vetor de recursos como inteiro
-            token = strtok(NULL, " ");  // Pega o próximo token
+            options->convertInput = argv[i + 1];
+            options->convertOutput = argv[i + 2];
+            i += 3;
         }
-
-        
-        if (strcmp(command, "RQ") == 0) // Executa o comando RQ
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc)
         {
-            requestResources(currentAllocation, remainingNeed, availableResources, numberOfCustomers, numberOfResources, customerID, resources, outputFile);
-        } 
-        else if (strcmp(command, "RL") == 0) // Executa o comando RL
+            options->serveSocket = argv[i + 1];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
         {
-            releaseResources(currentAllocation, remainingNeed, availableResources, customerID, numberOfResources, resources, outputFile);
-        } 
-        else // Se o comando não for RQ ou RL, fecha o arquivo e retorna 0 (arquivo mal formatado)
+            options->statsFile = argv[i + 1];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--compact") == 0)
         {
-            fclose(file);
-            free(line);
-            return 0;
+            options->compact = 1;
+            i++;
+        }
+        else if (strcmp(argv[i], "--pipeline") == 0)
+        {
+            options->pipeline = 1;
+            i++;
+        }
+        else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc)
+        {
+            options->checkpointFile = argv[i + 1];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--checkpoint-every") == 0 && i + 1 < argc && atol(argv[i + 1]) > 0)
+        {
+            options->checkpointEvery = atol(argv[i + 1]);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc)
+        {
+            options->restoreFile = argv[i + 1];
+            i += 2;
+        }
+        else
+        {
+            return -1;
         }
-
-        // Libera a memória da linha atual antes de ler a próxima linha
-        free(line);
-        line = NULL;
     }
-
-    fclose(file); 
-    free(line); // Libere qualquer memória que possa ter sido alocada
-    return 1;
+    return i;
 }
 
-
-// Processa recursos solicitados por um cliente e printa no arquivo se o pedido foi aceito ou negado e o motivo
-void requestResources(int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources, int customerID, int *requestedResources, FILE *outputFile) 
+// Processa os comandos do arquivo commands.txt, lidando com a alocação e liberação de recursos baseado nos comandos presentes no arquivo
+int processBankerCommands(const char *filename, int numberOfCustomers, int numberOfResources, OutputWriter *outputFile) 
 {
-    // Checa se o recurso solicitado é maior que a necessidade restante do cliente
-    for (int i = 0; i < numberOfResources; i++) 
+    int resources[numberOfResources]; // Guarda os recursos a serem alocados ou liberados (reaproveitado por todas as linhas)
+
+    // Mapeia o arquivo inteiro na memória e lê as linhas direto do mapeamento, sem cópias nem alocações por linha
+    MappedFile file;
+    if (!mapFile(filename, &file))
     {
-        // Se for, o recurso solicitado é maior que a necessidade restante do cliente, logo o pedido é negado
-        if (requestedResources[i] > remainingNeed[customerID][i]) 
-        {
-            fprintf(outputFile, "The customer %d request ", customerID);
-            for (int j = 0; j < numberOfResources; j++) 
-            {
-                fprintf(outputFile, "%d ", requestedResources[j]);
-            }
-            fprintf(outputFile, "was denied because exceed its maximum need\n");
-            return;
-        }
+        return 0;
     }
 
-    // Checa se o recurso solicitado é maior que o recurso disponível
-    for (int i = 0; i < numberOfResources; i++) 
+    CommandParser parser;
+    Command command;
+    int status;
+    initCommandParser(&parser, file.data, file.size, numberOfCustomers, numberOfResources, resources);
+
+    while ((status = nextCommand(&parser, &command)) > 0) // Lê cada linha do arquivo
     {
-        // Se for, o recurso solicitado é maior que o recurso disponível, logo o pedido é negado e printa no arquivo
-        if (requestedResources[i] > availableResources[i]) 
+        if (!executeCommand(bankerHandle, &command, outputFile))
         {
-            fprintf(outputFile, "The resources ");
-            for (int j = 0; j < numberOfResources; j++) 
-            {
-                fprintf(outputFile, "%d ", availableResources[j]);
-            }
-            fprintf(outputFile, "are not enough to customer %d request ", customerID);
-            for (int j = 0; j < numberOfResources; j++) 
-            {
-                fprintf(outputFile, "%d ", requestedResources[j]);
-            }
-            fprintf(outputFile, "\n");
-            return;
+            parser.error = commandError;
+            status = -1;
+            break;
         }
     }
 
-    int tempAvailable[numberOfResources]; // Vetor temporário para armazenar os recursos disponíveis
-    memcpy(tempAvailable, availableResources, numberOfResources * sizeof(int)); // Copia os recursos disponíveis para o vetor temporário
+    // Linha mal formada: avisa qual foi e para de processar o arquivo
+    if (status < 0)
+    {
+        printf("%s:%d: %s\n", filename, parser.lineNumber, parser.error);
+    }
 
-    // Checa se o estado é seguro
-    for (int i = 0; i < numberOfResources; i++) 
+    unmapFile(&file);
+    return status == 0;
+}
+
+// Executa os comandos de um trace binário (gerado com --convert-trace); a saída é a mesma do commands.txt original
+int replayBinaryCommands(const char *filename, int numberOfCustomers, int numberOfResources, OutputWriter *outputFile)
+{
+    BinaryTrace trace;
+    if (!openBinaryTrace(filename, &trace))
+    {
+        printf("%s: %s\n", filename, trace.error);
+        return 0;
+    }
+    if (trace.numberOfResources != numberOfResources)
     {
-        availableResources[i] -= requestedResources[i];            // Subtrai os recursos solicitados dos recursos disponíveis
-        currentAllocation[customerID][i] += requestedResources[i]; // Adiciona os recursos solicitados na alocação atual
-        remainingNeed[customerID][i] -= requestedResources[i];     // Subtrai os recursos solicitados da necessidade restante
+        closeBinaryTrace(&trace);
+        return 0;
     }
 
-    // Primeiro checa se o novo estado é seguro
-    if (!checkSafety(currentAllocation, remainingNeed, availableResources, numberOfCustomers, numberOfResources, NULL)) 
+    // Com --restore, os registros que o checkpoint já inclui são pulados direto (todos têm o mesmo tamanho)
+    size_t skipped = skipCommands < trace.recordCount ? (size_t)skipCommands : trace.recordCount;
+    trace.nextRecord = skipped;
+    skipCommands -= skipped;
+
+    Command command;
+    int status;
+    while ((status = nextTraceRecord(&trace, &command)) > 0) // Os registros são lidos direto do mapeamento
     {
-        // Se não for, reverte as mudanças feitas e printa no arquivo que o pedido foi negado
-        for (int i = 0; i < numberOfResources; i++) 
+        if (command.customerID >= numberOfCustomers) // O cliente do trace nunca é negativo (-1 em *, CP e QM de todos)
         {
-            availableResources[i] = tempAvailable[i];                  // Recupera os recursos disponíveis
-            currentAllocation[customerID][i] -= requestedResources[i]; // Recupera a alocação atual
-            remainingNeed[customerID][i] += requestedResources[i];     // Recupera a necessidade restante
+            trace.error = "customer number out of range";
+            status = -1;
+            break;
         }
-        fprintf(outputFile, "The customer %d request ", customerID);
-        for (int j = 0; j < numberOfResources; j++) 
+        if (!executeCommand(bankerHandle, &command, outputFile))
         {
-            fprintf(outputFile, "%d ", requestedResources[j]);
+            trace.error = commandError;
+            status = -1;
+            break;
         }
-        fprintf(outputFile, "was denied because result in an unsafe state\n");
-        return;
     }
 
-    // Se chegou até aqui significa que o estado é seguro, printa no arquivo que o pedido foi aceito
-    fprintf(outputFile, "Allocate to customer %d the resources ", customerID);
-    for (int i = 0; i < numberOfResources; i++) 
+    // Registro inválido: avisa qual foi e para de processar o trace
+    if (status < 0)
     {
-        fprintf(outputFile, "%d ", requestedResources[i]);
+        printf("%s: record %zu: %s\n", filename, trace.nextRecord, trace.error);
     }
-    fprintf(outputFile, "\n");
+
+    closeBinaryTrace(&trace);
+    return status == 0;
 }
 
-// Processa recursos liberados por um cliente e printa no arquivo se o pedido foi aceito ou negado e o motivo
-void releaseResources(int **currentAllocation, int **remainingNeed, int *availableResources, int customerID, int numberOfResources, int *resourcesToRelease, FILE *outputFile) 
+// Atende comandos no socket Unix socketPath até receber SIGINT ou SIGTERM
+int serveBankerCommands(const char *socketPath, Banker *banker)
 {
-    // Checa se o recurso liberado é maior que a alocação atual do cliente
-    for (int i = 0; i < numberOfResources; i++) 
+    bankerServer = createBankerServer(socketPath, getBankerState(banker), getBankerEngine(banker));
+    if (!bankerServer)
     {
-        // Se for, o recurso liberado é maior que a alocação atual do cliente, logo o pedido é negado
-        if (resourcesToRelease[i] > currentAllocation[customerID][i]) 
-        {
-            fprintf(outputFile, "The customer %d released ", customerID);
-            for (int j = 0; j < numberOfResources; j++) 
-            {
-                fprintf(outputFile, "%d ", resourcesToRelease[j]);
-            }
-            fprintf(outputFile, "was denied because exceed its maximum allocation\n");
-            return;
-        }
+        printf("Error: Unable to listen on %s\n", socketPath);
+        return 0;
     }
 
-    // Libera os recursos e printa no arquivo que o pedido foi aceito
-    for (int i = 0; i < numberOfResources; i++) 
+    // Sem SA_RESTART: o epoll_wait é interrompido e o servidor vê o pedido de parada
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleStopSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    printf("Listening on %s\n", socketPath);
+    fflush(stdout);
+    int ok = runBankerServer(bankerServer);
+    if (!ok)
     {
-        availableResources[i] += resourcesToRelease[i];            // Recupera os recursos disponíveis
-        currentAllocation[customerID][i] -= resourcesToRelease[i]; // Recupera a alocação atual
-        remainingNeed[customerID][i] += resourcesToRelease[i];     // Recupera a necessidade restante
+        printf("Error: epoll failed on %s\n", socketPath);
     }
 
-    // Se chegou até aqui, significa que o pedido foi aceito, printa no arquivo que o pedido foi aceito
-    fprintf(outputFile, "Release from customer %d the resources ", customerID);
-    for (int i = 0; i < numberOfResources; i++) 
+    destroyBankerServer(bankerServer);
+    bankerServer = NULL;
+    return ok;
+}
+
+void handleStopSignal(int signalNumber)
+{
+    (void)signalNumber;
+    if (bankerServer)
     {
-        fprintf(outputFile, "%d ", resourcesToRelease[i]);
+        stopBankerServer(bankerServer);
     }
-    fprintf(outputFile, "\n");
 }
 
-// Imprime as matrizes no arquivo de acordo com o numero de clientes(rows / linhas) e recursos(cols / colunas)
-void printAllMatrices(FILE *filePointer, int rows, int cols) 
+// Executa um comando já lido (de commands.txt ou do trace binário) e grava os checkpoints de CP e de --checkpoint-every
+// Retorna 0 (com o motivo em commandError) se um checkpoint não pôde ser gravado, se um QM é inválido ou, no modo
+// --compact, se o comando deixaria uma alocação fora das células (nada é aplicado)
+int executeCommand(Banker *banker, const Command *command, OutputWriter *outputFile)
 {
-    fprintf(filePointer, "MAXIMUM | ALLOCATION | NEED\n");
+    STATS_POLL(); // Escreve as estatísticas se chegou um SIGUSR1
 
-    for (int i = 0; i < rows; i++) 
+    // Com --restore, os comandos que o checkpoint já inclui não são executados de novo
+    if (skipCommands > 0)
     {
-        // MAXIMUM
-        for (int j = 0; j < cols; j++) 
-        {
-            fprintf(filePointer, "%d", maximumDemand[i][j]);
-            if (j == cols - 1) 
-            {
-                fprintf(filePointer, "   | ");  // Adiciona três espaços após o último número na coluna MAXIMUM
-            } 
-            else 
-            {
-                fprintf(filePointer, " ");
-            }
-        }
-
-        // ALLOCATION
-        for (int j = 0; j < cols; j++) 
-        {
-            fprintf(filePointer, "%d", currentAllocation[i][j]);
-            if (j == cols - 1) 
-            {
-                fprintf(filePointer, "      | ");  // Adiciona seis espaços após o último número na coluna ALLOCATION
-            } 
-            else 
-            {
-                fprintf(filePointer, " ");
-            }
-        }
+        skipCommands--;
+        return 1;
+    }
+    commandSequence++;
 
-        // NEED
-        for (int j = 0; j < cols; j++) 
-        {
-            fprintf(filePointer, "%d ", remainingNeed[i][j]);  // Espaçamento de um espaço após o último número na coluna NEED
-        }
-        fprintf(filePointer, "\n");
+    if (command->type == COMMAND_CHECKPOINT)
+    {
+        return writeCheckpoint(banker, outputFile);
     }
+    if (!applyCommand(banker, command, outputFile))
+    {
+        return 0;
+    }
+    if (checkpointEvery > 0 && commandSequence % checkpointEvery == 0)
+    {
+        return writeCheckpoint(banker, outputFile);
+    }
+    return 1;
 }
 
-// Banker's Algorithm para checar se o estado é seguro baseado na alocação atual, necessidade restante e recursos disponíveis
-int bankerAlgorithm(int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources) 
+// Grava o checkpoint de --checkpoint com os commandSequence comandos executados até aqui. Os pedidos do lote são decididos
+// antes e result.txt é descarregado e sincronizado, para a saída no disco cobrir os mesmos comandos que o checkpoint; o
+// tamanho dela vai no checkpoint, e --restore continua o result.txt desse ponto
+int writeCheckpoint(Banker *banker, OutputWriter *outputFile)
 {
-    // Vetor para armazenar a sequência segura dos clientes(processos) | A sequencia segura é a ordem em que os processos podem ser executados sem causar deadlock
-    int safeSequence[numberOfCustomers]; 
-    return checkSafety(currentAllocation, remainingNeed, availableResources, numberOfCustomers, numberOfResources, safeSequence); // Retorna 1 se o estado for seguro e 0 caso contrário
+    if (!checkpointFile)
+    {
+        commandError = "CP needs --checkpoint FILE";
+        return 0;
+    }
+    flushRequestBatch(banker, outputFile);
+    flushOutputWriter(outputFile);
+    if (outputFile->failed || fsync(outputFile->fileDescriptor) != 0
+        || !saveCheckpoint(checkpointFile, getBankerState(banker), commandSequence, outputWriterOffset(outputFile)))
+    {
+        commandError = "unable to write the checkpoint";
+        return 0;
+    }
+    return 1;
 }
 
-// Checa se o estado é seguro (O estado é seguro se existe uma sequência segura) | O verdadeiro Banker's Algorithm
-int checkSafety(int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources, int *safeSequence) 
+// Aplica um RQ, RL, * ou QM ao estado e escreve a saída. Retorna 0 com o motivo em commandError (ver executeCommand)
+int applyCommand(Banker *banker, const Command *command, OutputWriter *outputFile)
 {
-    int finished[numberOfCustomers]; // Vetor para armazenar se a NEED do cliente foi satisfeita ou não
-    int work[numberOfResources];     // Vetor que copia os recursos disponíveis, representando os recursos disponíveis que podem ser usados
-
-    memcpy(work, availableResources, numberOfResources * sizeof(int)); // Copia os recursos disponíveis para o vetor work
-    memset(finished, 0, numberOfCustomers * sizeof(int));              // Inicializa o vetor finished com 0
+    if (compactState)
+    {
+        return executeCompactCommand(command, outputFile);
+    }
 
-    // Checa cada cliente até que todos os clientes tenham sido processados
-    for (int k = 0; k < numberOfCustomers; k++) 
+    // No modo em lote, um RQ só entra no lote; qualquer outro comando primeiro decide os pedidos acumulados
+    if (requestBatch)
     {
-        // Checa o recurso NEED do cliente pode ser satisfeito com os recursos disponíveis (work)
-        for (int i = 0; i < numberOfCustomers; i++) 
+        if (command->type == COMMAND_REQUEST)
         {
-            if (!finished[i]) // Se a NEED do cliente não foi satisfeita
+            if (addBatchRequest(requestBatch, command->customerID, command->resources))
             {
-                int j;
-                for (j = 0; j < numberOfResources; j++)     // Checa se o recurso NEED do cliente pode ser satisfeito com os recursos disponíveis (work)
-                {
-                    if (remainingNeed[i][j] > work[j])      // Se o recurso NEED do cliente não pode ser satisfeito com os recursos disponíveis (work)
-                    {
-                        break;                              // Sai do loop e vai para o próximo cliente
-                    }
-                }
-                if (j == numberOfResources)                 // Se o recurso NEED do cliente pode ser satisfeito com os recursos disponíveis (work)
-                {
-                    for (j = 0; j < numberOfResources; j++) // Adiciona os recursos alocados pelo cliente aos recursos disponíveis (work)
-                    {
-                        work[j] += currentAllocation[i][j]; // Adiciona temporariamente os recursos alocados pelo cliente aos recursos disponíveis (work)
-                    }
-                    finished[i] = 1;                        // Marca o cliente como processado
-                    if (safeSequence != NULL)
-                    {
-                        safeSequence[k] = i;                // Adiciona o cliente a sequência segura
-                    } 
-                    break;                                  // Sai do loop e vai para o próximo cliente
-                }
+                flushRequestBatch(banker, outputFile);
             }
+            return 1;
         }
+        flushRequestBatch(banker, outputFile);
     }
 
-    // Checa se todos os clientes foram processados
-    for (int i = 0; i < numberOfCustomers; i++) 
+    if (command->type == COMMAND_PRINT) // Se a linha for igual a *, imprime as matrizes e os recursos disponíveis
     {
-        if (!finished[i]) 
-        {
-            return 0; // Não é seguro
-        }
+        writeStateSnapshot(outputFile, getBankerState(banker)); // Imprime as matrizes e os recursos disponíveis no arquivo
+    }
+    else if (command->type == COMMAND_QUERY) // Consulta o maior pedido aceito, sem mudar o estado
+    {
+        return queryGrantable(banker, command, outputFile);
     }
-    return 1; // Pode dale que é seguro
+    else if (command->type == COMMAND_REQUEST) // Executa o comando RQ
+    {
+        requestResources(banker, command->customerID, command->resources, outputFile);
+    }
+    else // Executa o comando RL
+    {
+        releaseResources(banker, command->customerID, command->resources, outputFile);
+    }
+    return 1;
 }
 
-// Conta o número de clientes no arquivo customer.txt
-int countNumberOfCustomers(const char *filename) 
+// executeCommand no modo --compact: as mesmas linhas de saída, com o estado compacto
+int executeCompactCommand(const Command *command, OutputWriter *outputFile)
 {
-    FILE *file = fopen(filename, "r");
-    if (!file) 
+    int numberOfResources = compactState->numberOfResources;
+    int available[numberOfResources + 1]; // Recursos disponíveis na ordem original (para a linha de recursos insuficientes)
+
+    if (command->type == COMMAND_PRINT)
     {
+        writeCompactSnapshot(outputFile, compactState);
+        return 1;
+    }
+    if (command->type == COMMAND_QUERY)
+    {
+        commandError = "QM is not supported with --compact";
         return 0;
     }
 
-    int customerCount = 0; // Conta o número de clientes
-    char *line = NULL;     // Inicializa line como NULL
-    size_t len = 0;        // Tamanho da linha
-
-    while (getline(&line, &len, file) != -1) // Lê cada linha do arquivo
+    if (command->type == COMMAND_REQUEST)
     {
-        customerCount++;
+        RequestDecision decision;
+        if (!compactAdmitRequest(compactState, command->customerID, command->resources, &decision))
+        {
+            commandError = "allocation does not fit the --compact cells";
+            return 0;
+        }
+        getCompactAvailable(compactState, available);
+        writeRequestDecision(outputFile, decision, command->customerID, command->resources, available, numberOfResources);
+        return 1;
     }
 
-    free(line);           // Libera a memória alocada por getline
-    fclose(file);         // Fecha o arquivo
-    return customerCount; // Retorna o número de clientes
+    int released;
+    if (!compactAdmitRelease(compactState, command->customerID, command->resources, &released))
+    {
+        commandError = "allocation does not fit the --compact cells";
+        return 0;
+    }
+    writeReleaseDecision(outputFile, released, command->customerID, command->resources, numberOfResources);
+    return 1;
 }
 
-
-// Conta o número de colunas (recursos) no arquivo customer.txt
-int countNumberOfResources(const char *filename) 
+// Executa um QM: o maior pedido aceito agora para um cliente, ou para todos (uma linha por cliente), sem mudar o estado
+// A direção só com zeros pede o máximo de cada recurso sozinho. Retorna 0 se a direção tem valor negativo
+int queryGrantable(Banker *banker, const Command *command, OutputWriter *outputFile)
 {
-    FILE *file = fopen(filename, "r");
-    if (!file) 
+    int numberOfResources = bankerNumberOfResources(banker);
+    const int *direction = isZeroVector(command->resources, numberOfResources) ? NULL : command->resources;
+    int customers = command->customerID < 0 ? bankerNumberOfCustomers(banker) : 1;
+    int *grantable = (int *)malloc(((size_t)customers * numberOfResources + 1) * sizeof(int));
+    if (!grantable)
     {
-        return -1;
+        commandError = "unable to allocate the query result";
+        return 0;
     }
 
-    char *line = NULL; // Inicializa line como NULL
-    size_t len = 0;    // Tamanho da linha
-    if (getline(&line, &len, file) == -1) 
+    int ok = bankerMaxGrantable(banker, command->customerID, direction, grantable);
+    for (int k = 0; ok && k < customers; k++)
     {
-        fclose(file);
-        if (line) free(line); // Libera a memória se getline foi chamada
-        return -1;
+        int customerID = command->customerID < 0 ? k : command->customerID;
+        writeGrantableQuery(outputFile, customerID, grantable + (size_t)k * numberOfResources, direction, numberOfResources);
     }
-
-    int resourceCount = 0;           // Conta o número de recursos
-    char *token = strtok(line, ","); // Divide a linha em tokens separados por vírgula
-
-    while (token != NULL)            // Lê cada token
+    free(grantable);
+    if (!ok)
     {
-        resourceCount++;             // Incrementa o número de recursos
-        token = strtok(NULL, ",");   // Pega o próximo token
+        commandError = "query direction must be non-negative";
     }
-
-    free(line); // Libera a memória alocada por getline
-    fclose(file);
-    return resourceCount;
+    return ok;
 }
 
-
-// Aloca memória para uma matriz 2D
-int** allocate2DMatrix(int rows, int cols) 
+// Admite os pedidos do lote e escreve uma linha por pedido, na ordem do arquivo (as mesmas linhas de requestResources)
+void flushRequestBatch(Banker *banker, OutputWriter *outputFile)
 {
-    int **matrix = (int **)malloc(rows * sizeof(int *)); // Aloca memória para a matriz
+    if (!requestBatch || requestBatch->count == 0)
+    {
+        return;
+    }
+
+    BankerState *state = getBankerState(banker);
+    int numberOfResources = state->numberOfResources;
+    int count = requestBatch->count;
+    int available[numberOfResources + 1]; // Recursos disponíveis vistos por cada pedido, refeitos a partir do início do lote
+    memcpy(available, state->availableResources, numberOfResources * sizeof(int));
 
-    // Aloca memória para cada linha da matriz
-    for (int i = 0; i < rows; i++) 
+    admitRequestBatch(requestBatch, state, getBankerEngine(banker));
+
+    for (int k = 0; k < count; k++)
     {
-        matrix[i] = (int *)malloc(cols * sizeof(int)); // Aloca memória para cada coluna da matriz
+        const Command *request = &requestBatch->requests[k];
+        RequestDecision decision = requestBatch->decisions[k];
+        writeRequestDecision(outputFile, decision, request->customerID, request->resources, available, numberOfResources);
+        for (int j = 0; decision == REQUEST_GRANTED && j < numberOfResources; j++)
+        {
+            available[j] -= request->resources[j];
+        }
     }
-    return matrix; // Retorna a matriz alocada
 }
 
-// Libera a memória alocada para uma matriz 2D
-void free2DMatrix(int **matrix, int rows) 
+// Processa recursos solicitados por um cliente e printa no arquivo se o pedido foi aceito ou negado e o motivo
+void requestResources(Banker *banker, int customerID, int *requestedResources, OutputWriter *outputFile) 
 {
-    // Libera a memória alocada para cada linha da matriz
-    for (int i = 0; i < rows; i++) 
-    {
-        free(matrix[i]); // Libera a memória alocada para cada coluna da matriz
-    }
-    free(matrix); // Libera a memória alocada para a matriz
-}
\ No newline at end of file
+    // Decide o pedido (limites de NEED e de disponíveis, depois a segurança); se negado, o estado não muda
+    BankerDecision decision = bankerRequest(banker, customerID, requestedResources);
+    writeRequestDecision(outputFile, (RequestDecision)decision.status, customerID, requestedResources, decision.available, bankerNumberOfResources(banker));
+}
+
+// Processa recursos liberados por um cliente e printa no arquivo se o pedido foi aceito ou negado e o motivo
+void releaseResources(Banker *banker, int customerID, int *resourcesToRelease, OutputWriter *outputFile) 
+{
+    // Se o recurso liberado for maior que a alocação atual do cliente, o pedido é negado (o estado não muda)
+    BankerDecision decision = bankerRelease(banker, customerID, resourcesToRelease);
+    writeReleaseDecision(outputFile, decision.status == BANKER_GRANTED, customerID, resourcesToRelease, bankerNumberOfResources(banker));
+}
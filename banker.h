@@ -0,0 +1,443 @@
+#ifndef BANKER_H
+#define BANKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "libbanker.h"
+
+#define BANKER_ROW_ALIGNMENT 64 // Alinhamento (bytes) do início de cada matriz
+#define BANKER_ROW_PADDING 8    // As linhas têm um múltiplo de 8 ints (32 bytes)
+
+// Estado do banqueiro (state.c)
+// Cada matriz fica num único buffer contíguo: a linha i começa em matriz + i * rowStride
+typedef struct
+{
+    int numberOfCustomers;
+    int numberOfResources;
+    int rowStride;           // Número de ints por linha, incluindo o padding
+    int *maximumDemand;      // Matriz de demanda máxima
+    int *currentAllocation;  // Matriz de alocação atual
+    int *remainingNeed;      // Matriz de necessidade restante
+    int *availableResources; // Vetor de recursos disponíveis
+    const struct WidthKernels *widthKernels; // Variante da checagem para 4, 8 ou 16 recursos (NULL: caminho genérico)
+} BankerState;
+
+// Bloco de memória dividido em pedaços alinhados (state.c): o estado e o motor ficam cada um num bloco só, e um Banker
+// (library.c) pode ter os dois no mesmo bloco. Com base NULL a arena só mede os bytes que a montagem usaria
+typedef struct
+{
+    char *base;
+    size_t size;
+    size_t used;
+} BankerArena;
+
+// Estado compacto (compact.c, --compact): só a demanda máxima e a alocação, sem a matriz NEED (calculada como máximo - alocação)
+// Cada recurso é guardado em 8, 16 ou 32 bits conforme o maior valor da sua coluna em customer.txt. Os recursos ficam
+// agrupados por largura (primeiro os de 8 bits, depois os de 16 e os de 32), cada grupo numa matriz contígua linha a linha
+#define COMPACT_GROUPS 3
+
+typedef struct
+{
+    int numberOfCustomers;
+    int numberOfResources;
+    int groupSize[COMPACT_GROUPS]; // Número de recursos em 8, 16 e 32 bits
+    int *resourceOrder;      // resourceOrder[k]: recurso original na posição k da ordem compacta
+    int *cellLimit;          // Maior valor que cabe na célula de cada posição (a alocação também tem que caber)
+    uint8_t *maximum8;       // numberOfCustomers x groupSize[0]
+    uint8_t *allocation8;
+    uint16_t *maximum16;     // numberOfCustomers x groupSize[1]
+    uint16_t *allocation16;
+    uint32_t *maximum32;     // numberOfCustomers x groupSize[2]
+    uint32_t *allocation32;
+    int *available;          // Recursos disponíveis, na ordem compacta
+
+    // Checagem de segurança: só a última sequência segura, sem as ordenações por recurso do motor incremental
+    // A alocação nunca é negativa (não cabe na célula), então a ordem em que os clientes terminam não muda o veredito
+    int *safeSequence;       // Sequência segura do estado atual, se hasSafeSequence
+    int hasSafeSequence;
+    int *candidateSequence;  // Sequência montada durante a checagem
+    uint8_t *finished;
+    int *work;               // Na ordem compacta
+    long fastApprovals;      // Como no SafetyEngine
+    long cacheHits;
+    long cacheMisses;
+} CompactState;
+
+// Saída bufferizada de result.txt (output.c)
+#define OUTPUT_BUFFER_SIZE (1 << 20) // Os dados vão para o arquivo em blocos de até 1 MiB
+
+typedef struct
+{
+    int fileDescriptor; // -1 no writer em memória
+    char *buffer;
+    size_t capacity;
+    size_t length;   // Bytes ocupados no buffer
+    int failed;      // 1 se alguma escrita falhou
+} OutputWriter;
+
+// Leitura de commands.txt (parser.c)
+typedef struct
+{
+    const char *data; // Conteúdo do arquivo mapeado com mmap
+    size_t size;
+} MappedFile;
+
+typedef enum
+{
+    COMMAND_REQUEST, // RQ
+    COMMAND_RELEASE, // RL
+    COMMAND_PRINT,   // *
+    COMMAND_CHECKPOINT, // CP: grava um checkpoint do estado (--checkpoint FILE)
+    COMMAND_QUERY    // QM: maior pedido que o cliente (ou todos, customerID = -1) consegue sem deixar o estado inseguro
+} CommandType;
+
+typedef struct
+{
+    CommandType type;
+    int customerID;
+    int *resources;  // Aponta para o vetor do parser (ou para o trace binário), válido até o próximo comando
+                     // Em QM é a direção da consulta (só zeros: por recurso)
+} Command;
+
+typedef struct
+{
+    const char *cursor;    // Início da próxima linha
+    const char *end;
+    int lineNumber;        // Número da última linha lida (começa em 1)
+    int numberOfCustomers;
+    int numberOfResources;
+    int *resources;
+    const char *error;     // Motivo da última linha mal formada
+} CommandParser;
+
+// Resultado da leitura de customer.txt (loadCustomerFile e loadCompactState)
+typedef enum
+{
+    CUSTOMERS_LOADED,
+    CUSTOMERS_UNREADABLE,     // Não foi possível abrir o arquivo
+    CUSTOMERS_WIDTH_MISMATCH, // A primeira linha não tem o número de recursos da linha de comando
+    CUSTOMERS_MALFORMED,      // Alguma linha tem menos valores que recursos
+    CUSTOMERS_NEGATIVE,       // Valor negativo (só no estado compacto, que não guarda negativos)
+    CUSTOMERS_NO_MEMORY
+} CustomerFileStatus;
+
+// Opcodes dos comandos no trace binário e no protocolo do servidor
+#define COMMAND_OPCODE_REQUEST 1  // RQ
+#define COMMAND_OPCODE_RELEASE 2  // RL
+#define COMMAND_OPCODE_SNAPSHOT 3 // *
+#define COMMAND_OPCODE_QUERY 0    // QM (só no trace binário)
+
+// Trace binário de comandos (trace.c), gerado a partir de commands.txt com --convert-trace
+#define BINARY_TRACE_VERSION 1
+#define TRACE_CHECKPOINT_MARK 1 // Registro de * com este valor no lugar do cliente: é um CP
+
+// Checkpoint binário do estado (snapshot.c): --checkpoint grava, --restore recomeça dele
+#define CHECKPOINT_VERSION 1
+
+typedef struct
+{
+    MappedFile file;
+    int numberOfResources;
+    int valueWidth;        // Bytes por valor de recurso: 1 (int8), 2 (int16) ou 4 (int32)
+    size_t recordSize;     // Todos os registros têm o mesmo tamanho
+    size_t recordCount;
+    size_t nextRecord;     // Índice do próximo registro a ler
+    int *widened;          // Valores int8/int16 convertidos para int
+    const char *error;     // Motivo da última falha
+} BinaryTrace;
+
+// Admissão em lote de pedidos RQ consecutivos (batch.c)
+typedef enum
+{
+    REQUEST_GRANTED,       // Aceito
+    REQUEST_EXCEEDS_NEED,  // Negado: maior que a NEED do cliente
+    REQUEST_NOT_AVAILABLE, // Negado: maior que os recursos disponíveis
+    REQUEST_UNSAFE         // Negado: levaria a um estado inseguro
+} RequestDecision;
+
+typedef struct
+{
+    int capacity;
+    int count;                  // Pedidos no lote
+    int numberOfResources;
+    Command *requests;          // Pedidos na ordem do arquivo
+    int *resources;             // Cópia dos valores de cada pedido
+    int *changedCustomers;      // Clientes dos pedidos aplicados durante a admissão
+    RequestDecision *decisions; // Decisão de cada pedido depois de admitRequestBatch
+} RequestBatch;
+
+// Estatísticas de decisões e do caminho quente (stats.c), ligadas com --stats FILE
+// Só são compiladas com -DBANKER_STATS (make STATS=1); sem a flag os macros STATS_* não geram código nenhum
+#define STATS_HISTOGRAM_BUCKETS 40 // Potências de 2
+
+#ifdef BANKER_STATS
+#include <signal.h>
+
+typedef struct
+{
+    long requests;
+    long granted;
+    long deniedExceedsNeed;
+    long deniedNotAvailable;
+    long deniedUnsafe;
+    long releases;
+    long releasesDenied;
+    long snapshots;
+    long rollbacks;        // Pedidos do lote aplicados e desfeitos (fora do prefixo aceito); fora do lote a checagem não escreve
+    long commitConflicts;  // Commits otimistas refeitos no núcleo concorrente
+    long safetyChecks;
+    long fastApprovals;    // Do motor incremental, como os campos de mesmo nome do SafetyEngine
+    long cacheHits;
+    long cacheMisses;
+    long checkLatencyTotal;                      // ns
+    long checkLatency[STATS_HISTOGRAM_BUCKETS];  // ns, bucket 0 = zero, bucket k = [2^(k-1), 2^k)
+    long checkPasses[STATS_HISTOGRAM_BUCKETS];   // Passadas sobre os clientes em cada checagem
+} BankerStats;
+
+extern BankerStats bankerStats;
+extern int bankerStatsEnabled;
+extern volatile sig_atomic_t bankerStatsDumpRequested;
+
+void enableBankerStats(const char *filename);
+int dumpBankerStats(void);
+void pollBankerStats(void);
+long statsNow(void);
+void statsRecordHistogram(long *histogram, long value);
+void statsRecordDecision(RequestDecision decision);
+
+#define STATS_ADD(field, amount) do { if (bankerStatsEnabled) __atomic_fetch_add(&bankerStats.field, (amount), __ATOMIC_RELAXED); } while (0)
+#define STATS_COUNT(field) STATS_ADD(field, 1)
+#define STATS_DECISION(decision) do { if (bankerStatsEnabled) statsRecordDecision(decision); } while (0)
+#define STATS_PASSES(passes) do { if (bankerStatsEnabled) statsRecordHistogram(bankerStats.checkPasses, (passes)); } while (0)
+#define STATS_TIMER_START(timer) long timer = bankerStatsEnabled ? statsNow() : 0
+#define STATS_TIMER_STOP(timer) do { if (bankerStatsEnabled) { long elapsed_ = statsNow() - (timer); \
+        STATS_COUNT(safetyChecks); STATS_ADD(checkLatencyTotal, elapsed_); statsRecordHistogram(bankerStats.checkLatency, elapsed_); } } while (0)
+#define STATS_POLL() do { if (bankerStatsDumpRequested) pollBankerStats(); } while (0)
+#else
+#define STATS_ADD(field, amount) ((void)0)
+#define STATS_COUNT(field) ((void)0)
+#define STATS_DECISION(decision) ((void)0)
+#define STATS_PASSES(passes) ((void)(passes)) // Só leituras de variáveis locais, some na otimização
+#define STATS_TIMER_START(timer) ((void)0)
+#define STATS_TIMER_STOP(timer) ((void)0)
+#define STATS_POLL() ((void)0)
+#endif
+
+// Servidor num socket Unix (server.c)
+#define SERVER_PROTOCOL_VERSION 1
+#define SERVER_STATUS_OK 0                 // RL aplicado ou resposta de *; em RQ o status é o RequestDecision (0 a 3)
+#define SERVER_STATUS_EXCEEDS_ALLOCATION 4 // RL negado: maior que a alocação atual do cliente
+#define SERVER_STATUS_INVALID 5            // Cliente fora do intervalo ou opcode inválido
+
+typedef struct BankerServer BankerServer;
+
+// Execução em três threads (pipeline.c, --pipeline): leitura -> decisão -> escrita de result.txt, ligadas por filas SPSC
+#define PIPELINE_RING_BYTES (1 << 20) // Tamanho máximo de cada fila de comandos
+
+// Pedido hipotético checado sem escrever no estado (safety.c): o estado base com os disponíveis e a linha de um cliente trocados
+// Os vetores têm rowStride ints com o padding zerado, como as linhas do estado
+typedef struct
+{
+    int customerID;        // -1: nenhuma troca, o próprio estado
+    const int *available;  // Disponíveis depois do pedido
+    const int *allocation; // Alocação do cliente depois do pedido
+    const int *need;       // NEED do cliente depois do pedido
+} SafetyOverlay;
+
+// Motor incremental de segurança (safety.c)
+typedef struct
+{
+    int numberOfCustomers;
+    int numberOfResources;
+    int rowStride;        // Tamanho de work (as linhas do estado têm padding zerado)
+    int **order;          // order[j]: clientes ordenados pela NEED do recurso j (crescente)
+    int **rank;           // rank[j][i]: posição do cliente i em order[j]
+    int *safeSequence;    // Última sequência segura conhecida
+    int hasSafeSequence;  // 1 se safeSequence é uma sequência segura do estado atual (fora do meio de uma checagem)
+    int *candidateSequence; // Sequência montada durante a checagem atual
+    int *finished;        // Clientes já processados na checagem atual
+    int *satisfiedCount;  // Número de recursos em que a NEED do cliente cabe em work
+    int *readyQueue;      // Fila de clientes prontos para terminar
+    int *cursor;          // Posição de cada recurso em order[j]
+    int *work;            // Recursos disponíveis durante a checagem
+    int *changedMark;     // 1 para os clientes fora de ordem nas ordenações durante a checagem atual
+    void *needEntries;    // Pares (NEED, cliente) usados só para montar as ordenações
+    int *negativeAllocation;     // 1 se a alocação do cliente (na última atualização) tem algum valor negativo
+    int negativeAllocationCount; // Clientes com negativeAllocation = 1
+    long fastApprovals;   // Checagens aprovadas sem percorrer a sequência (o cliente alterado termina com os disponíveis)
+    long cacheHits;       // Checagens em que a sequência guardada continuou segura
+    long cacheMisses;     // Checagens que repararam a sequência ou montaram uma (sem sequência guardada)
+    long fullChecks;      // Checagens feitas por checkSafety por causa de alocação negativa
+    struct ThreadPool *pool; // Com --threads N, repara a sequência com a checagem paralela; NULL: pelas ordenações
+} SafetyEngine;
+
+// Núcleo para várias threads decidindo pedidos e liberações sobre o mesmo estado (concurrent.c)
+typedef struct ConcurrentBanker ConcurrentBanker;
+
+typedef struct
+{
+    ConcurrentBanker *banker;
+    BankerState *snapshot;   // Cópia do estado onde os pedidos desta thread são decididos
+    SafetyEngine *engine;    // Motor incremental sobre o snapshot
+    long *rowVersion;        // Versão de cada linha no snapshot (só as linhas com versão nova são copiadas)
+    int *changedRows;        // Linhas copiadas que o motor ainda não viu
+    int *rowChanged;         // 1 para as linhas em changedRows
+    int changedCount;
+    long conflicts;          // Commits que falharam porque outro pedido foi aplicado antes
+    long snapshotRetries;    // Snapshots copiados durante uma escrita (refeitos)
+} ConcurrentWorker;
+
+// Pool de threads da checagem de segurança paralela (parallel.c)
+typedef struct ThreadPool ThreadPool;
+
+// Kernels do laço interno da checagem de segurança (simd.c), escolhidos em tempo de execução
+typedef struct
+{
+    const char *name;
+    int (*needFitsWork)(const int *need, const int *work, int length);     // 1 se need[j] <= work[j] para todo j
+    void (*addToWork)(int *work, const int *allocation, int length);       // work[j] += allocation[j]
+    // Primeiro i em [first, last) com finished[i] = 0 e a linha i de needs (rowStride ints cada) cabendo em work, ou -1
+    // O laço pelos clientes fica dentro do kernel: uma chamada indireta por passada, não uma por linha
+    int (*firstFitting)(const int *needs, int rowStride, const int *finished, int first, int last, const int *work);
+} SafetyKernels;
+
+// Laços da checagem de segurança especializados para um número fixo de recursos (width.c), escolhidos quando o estado é
+// criado (BankerState.widthKernels). Com a largura conhecida na compilação, work fica em registradores e as comparações
+// são desenroladas
+typedef struct WidthKernels
+{
+    int numberOfResources;
+    int (*checkSafety)(const BankerState *state, const SafetyOverlay *overlay, int *safeSequence); // overlay não nulo
+    int (*walkSequence)(const BankerState *state, const SafetyOverlay *overlay, const int *sequence, int *work, int *finished);
+} WidthKernels;
+
+extern const SafetyKernels scalarKernels;
+extern const SafetyKernels sse2Kernels;
+extern const SafetyKernels avx2Kernels;
+
+// Acesso às linhas das matrizes do estado
+static inline int* maximumRow(const BankerState *state, int customerID)
+{
+    return state->maximumDemand + (size_t)customerID * state->rowStride;
+}
+
+static inline int* allocationRow(const BankerState *state, int customerID)
+{
+    return state->currentAllocation + (size_t)customerID * state->rowStride;
+}
+
+static inline int* needRow(const BankerState *state, int customerID)
+{
+    return state->remainingNeed + (size_t)customerID * state->rowStride;
+}
+
+// Linhas do estado vistas através de um pedido hipotético
+static inline const int* overlayAllocationRow(const BankerState *state, const SafetyOverlay *overlay, int customerID)
+{
+    return customerID == overlay->customerID ? overlay->allocation : allocationRow(state, customerID);
+}
+
+static inline const int* overlayNeedRow(const BankerState *state, const SafetyOverlay *overlay, int customerID)
+{
+    return customerID == overlay->customerID ? overlay->need : needRow(state, customerID);
+}
+
+// Declaração das Funções
+OutputWriter* openOutputWriter(const char *filename);
+OutputWriter* openOutputWriterAt(const char *filename, unsigned long long offset);
+unsigned long long outputWriterOffset(const OutputWriter *writer);
+OutputWriter* openMemoryWriter(size_t capacity);
+int closeOutputWriter(OutputWriter *writer);
+void flushOutputWriter(OutputWriter *writer);
+void writerPutBytes(OutputWriter *writer, const char *data, size_t length);
+void writerPutString(OutputWriter *writer, const char *text);
+void writerPutInt(OutputWriter *writer, int value);
+void writerPutVector(OutputWriter *writer, const int *values, int count);
+void printAllMatrices(OutputWriter *filePointer, const BankerState *state);
+void writeStateSnapshot(OutputWriter *writer, const BankerState *state);
+void writeCompactSnapshot(OutputWriter *writer, const CompactState *state);
+void writeRequestDecision(OutputWriter *outputFile, RequestDecision decision, int customerID, const int *requestedResources, const int *availableResources, int numberOfResources);
+void writeReleaseDecision(OutputWriter *outputFile, int released, int customerID, const int *releasedResources, int numberOfResources);
+void writeGrantableQuery(OutputWriter *outputFile, int customerID, const int *grantable, const int *direction, int numberOfResources);
+int mapFile(const char *filename, MappedFile *file);
+void unmapFile(MappedFile *file);
+void initCommandParser(CommandParser *parser, const char *data, size_t size, int numberOfCustomers, int numberOfResources, int *resources);
+int nextCommand(CommandParser *parser, Command *command);
+int parseCustomerRow(const char **cursor, const char *end, int *values, int numberOfResources);
+void measureCustomerFile(const char *data, size_t size, int *numberOfCustomers, int *numberOfResources);
+BankerState* loadCustomerFile(const char *filename, int numberOfResources, CustomerFileStatus *status);
+int openBinaryTrace(const char *filename, BinaryTrace *trace);
+void closeBinaryTrace(BinaryTrace *trace);
+int nextTraceRecord(BinaryTrace *trace, Command *command);
+long convertTextTrace(const char *textFilename, const char *binaryFilename);
+int saveCheckpoint(const char *filename, const BankerState *state, unsigned long long sequence, unsigned long long outputOffset);
+BankerState* loadCheckpoint(const char *filename, unsigned long long *sequence, unsigned long long *outputOffset, const char **error);
+BankerState* createBankerState(int numberOfCustomers, int numberOfResources);
+void destroyBankerState(BankerState *state);
+BankerState* arenaBankerState(BankerArena *arena, int numberOfCustomers, int numberOfResources);
+void* arenaAllocate(BankerArena *arena, size_t bytes);
+void* allocateArenaBlock(size_t size);
+int bankerRowStride(int numberOfResources);
+int rowHasNegative(const int *row, int length);
+int hasNegativeAllocation(const BankerState *state);
+CompactState* createCompactState(int numberOfCustomers, int numberOfResources, const int *columnMaximum);
+void destroyCompactState(CompactState *state);
+CompactState* loadCompactState(const char *filename, int numberOfResources, CustomerFileStatus *status);
+size_t compactStateBytes(const CompactState *state);
+void setCompactMaximumRow(CompactState *state, int customerID, const int *maximum);
+void setCompactAvailable(CompactState *state, const int *available);
+void getCompactRow(const CompactState *state, int customerID, int *maximum, int *allocation, int *need);
+void getCompactAvailable(const CompactState *state, int *available);
+int compactAdmitRequest(CompactState *state, int customerID, const int *request, RequestDecision *decision);
+int compactAdmitRelease(CompactState *state, int customerID, const int *release, int *released);
+const SafetyKernels* findSafetyKernels(const char *name);
+const SafetyKernels* detectSafetyKernels(void);
+void setSafetyKernels(const SafetyKernels *kernels);
+const SafetyKernels* getSafetyKernels(void);
+const WidthKernels* findWidthKernels(int numberOfResources);
+RequestDecision checkRequestLimits(const BankerState *state, int customerID, const int *request);
+RequestDecision admitRequest(BankerState *state, SafetyEngine *engine, int customerID, const int *request);
+int admitRelease(BankerState *state, SafetyEngine *engine, int customerID, const int *release);
+int maxGrantableRequest(const BankerState *state, SafetyEngine *engine, int customerID, const int *direction, int *grantable);
+int maxGrantableAll(const BankerState *state, SafetyEngine *engine, const int *direction, int *grantable);
+int isZeroVector(const int *values, int length);
+Banker* adoptBankerState(BankerState *state, int numberOfThreads);
+BankerState* getBankerState(const Banker *banker);
+SafetyEngine* getBankerEngine(const Banker *banker);
+RequestBatch* createRequestBatch(int capacity, int numberOfResources);
+void destroyRequestBatch(RequestBatch *batch);
+int addBatchRequest(RequestBatch *batch, int customerID, const int *resources);
+int admitRequestBatch(RequestBatch *batch, BankerState *state, SafetyEngine *engine);
+int bankerAlgorithm(const BankerState *state);
+int checkSafety(const BankerState *state, int *safeSequence);
+int checkSafetyOverlay(const BankerState *state, const SafetyOverlay *overlay, int *safeSequence);
+ThreadPool* createThreadPool(int numberOfThreads);
+void destroyThreadPool(ThreadPool *pool);
+int threadPoolSize(const ThreadPool *pool);
+int checkSafetyParallel(ThreadPool *pool, const BankerState *state);
+int checkSafetyParallelOverlay(ThreadPool *pool, const BankerState *state, const SafetyOverlay *overlay);
+int checkSafetyParallelRepair(ThreadPool *pool, const BankerState *state, const SafetyOverlay *overlay, int *work, const int *finished, int *sequence, int completed);
+SafetyEngine* createSafetyEngine(const BankerState *state);
+void destroySafetyEngine(SafetyEngine *engine);
+SafetyEngine* arenaSafetyEngine(BankerArena *arena, int numberOfCustomers, int numberOfResources);
+void rebuildSafetyEngine(SafetyEngine *engine, const BankerState *state);
+int safetyEngineCheck(SafetyEngine *engine, const BankerState *state, int changedCustomer);
+int safetyEngineCheckChanged(SafetyEngine *engine, const BankerState *state, const int *changedCustomers, int changedCount);
+int safetyEngineCheckOverlay(SafetyEngine *engine, const BankerState *state, const SafetyOverlay *overlay);
+int safetyEngineFastApproval(SafetyEngine *engine, const BankerState *state, int customerID);
+void safetyEngineUpdateCustomer(SafetyEngine *engine, const BankerState *state, int customerID);
+void safetyEngineUpdateCustomers(SafetyEngine *engine, const BankerState *state, const int *customers, int count);
+ConcurrentBanker* createConcurrentBanker(BankerState *state);
+void destroyConcurrentBanker(ConcurrentBanker *banker);
+ConcurrentWorker* createConcurrentWorker(ConcurrentBanker *banker);
+void destroyConcurrentWorker(ConcurrentWorker *worker);
+RequestDecision concurrentRequest(ConcurrentWorker *worker, int customerID, const int *request, long *order);
+int concurrentRelease(ConcurrentBanker *banker, int customerID, const int *release, long *order);
+BankerServer* createBankerServer(const char *socketPath, BankerState *state, SafetyEngine *engine);
+void destroyBankerServer(BankerServer *server);
+void stopBankerServer(BankerServer *server);
+int runBankerServer(BankerServer *server);
+int runCommandPipeline(const char *filename, int binaryTrace, BankerState *state, SafetyEngine *engine, OutputWriter *writer);
+
+#endif
@@ -0,0 +1,277 @@
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+// Admissão em lote de pedidos RQ consecutivos
+//
+// Regra de ordenação: os pedidos são decididos na ordem do arquivo, cada um contra o estado que resulta dos pedidos
+// aceitos antes dele no lote. As decisões (e as linhas de result.txt) são exatamente as do processamento um a um.
+//
+// Isso permite buscar o maior prefixo aceito em vez de checar pedido por pedido: se o estado com os k primeiros pedidos
+// aplicados é seguro, o estado com k - 1 também é (devolver um pedido só aumenta work antes do cliente terminar).
+// Então a segurança dos prefixos é monótona e a fronteira sai com uma checagem no lote todo, ou com busca exponencial
+// seguida de busca binária quando algum pedido é negado. A monotonia depende de as alocações nunca serem negativas:
+// um pedido com valor negativo é decidido sozinho, e enquanto houver alocação negativa no estado os pedidos também.
+//
+// Antes de abrir um trecho, o pedido tenta o caminho rápido do motor (o cliente termina já com os disponíveis), como no
+// processamento um a um: aprovado em O(m), sem checagem. A busca por prefixo só começa no primeiro pedido que não passa.
+
+static int hasNegativeValue(const Command *request, int numberOfResources);
+static int admitFastRequest(BankerState *state, SafetyEngine *engine, const Command *request);
+static void applyRequest(BankerState *state, const Command *request, int sign);
+static void moveToPrefix(BankerState *state, const Command *requests, int *applied, int target);
+static int checkBatchSafety(RequestBatch *batch, BankerState *state, SafetyEngine *engine, int applied);
+
+// Cria um lote de até capacity pedidos com numberOfResources recursos cada
+RequestBatch* createRequestBatch(int capacity, int numberOfResources)
+{
+    RequestBatch *batch = (RequestBatch *)calloc(1, sizeof(RequestBatch));
+    if (!batch)
+    {
+        return NULL;
+    }
+
+    batch->capacity = capacity;
+    batch->numberOfResources = numberOfResources;
+    batch->requests = (Command *)malloc(capacity * sizeof(Command));
+    batch->resources = (int *)malloc((size_t)capacity * (numberOfResources + 1) * sizeof(int));
+    batch->changedCustomers = (int *)malloc(capacity * sizeof(int));
+    batch->decisions = (RequestDecision *)malloc(capacity * sizeof(RequestDecision));
+
+    if (!batch->requests || !batch->resources || !batch->changedCustomers || !batch->decisions)
+    {
+        destroyRequestBatch(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+void destroyRequestBatch(RequestBatch *batch)
+{
+    if (!batch)
+    {
+        return;
+    }
+
+    free(batch->requests);
+    free(batch->resources);
+    free(batch->changedCustomers);
+    free(batch->decisions);
+    free(batch);
+}
+
+// Copia um pedido para o lote. Retorna 1 se o lote ficou cheio (hora de chamar admitRequestBatch)
+int addBatchRequest(RequestBatch *batch, int customerID, const int *resources)
+{
+    Command *request = &batch->requests[batch->count];
+    request->type = COMMAND_REQUEST;
+    request->customerID = customerID;
+    request->resources = batch->resources + (size_t)batch->count * (batch->numberOfResources + 1);
+    memcpy(request->resources, resources, batch->numberOfResources * sizeof(int));
+    batch->count++;
+    return batch->count == batch->capacity;
+}
+
+// Decide todos os pedidos do lote, aplica os aceitos no estado e atualiza o motor incremental (se houver)
+// As decisões ficam em batch->decisions; o lote é esvaziado. Retorna o número de checagens de segurança feitas (com as
+// aprovações pelo caminho rápido)
+// A checagem usa o motor se houver (com o pool dele no reparo), senão checkSafety
+int admitRequestBatch(RequestBatch *batch, BankerState *state, SafetyEngine *engine)
+{
+    int count = batch->count;
+    int checks = 0;
+    int start = 0;
+    int negativeAllocation = engine ? engine->negativeAllocationCount > 0 : hasNegativeAllocation(state);
+
+    while (start < count)
+    {
+        // Aplica os pedidos em sequência enquanto passam nos limites de NEED e de recursos disponíveis
+        int length = 0;
+        int stoppedAtLimit = 0; // 1 se o pedido start + length foi negado pelos limites
+        int single = negativeAllocation || hasNegativeValue(&batch->requests[start], state->numberOfResources);
+        if (engine && !single && admitFastRequest(state, engine, &batch->requests[start]))
+        {
+            batch->decisions[start++] = REQUEST_GRANTED;
+            checks++;
+            continue;
+        }
+        while (start + length < count)
+        {
+            const Command *request = &batch->requests[start + length];
+            if (length > 0 && (single || hasNegativeValue(request, state->numberOfResources)))
+            {
+                break;
+            }
+            RequestDecision decision = checkRequestLimits(state, request->customerID, request->resources);
+            if (decision != REQUEST_GRANTED)
+            {
+                batch->decisions[start + length] = decision;
+                stoppedAtLimit = 1;
+                break;
+            }
+            applyRequest(state, request, 1);
+            batch->changedCustomers[length] = request->customerID;
+            length++;
+        }
+
+        if (length == 0)
+        {
+            start++;
+            continue;
+        }
+
+        // Caso comum: o prefixo inteiro é seguro
+        int granted = length;
+        int applied = length;
+        checks++;
+        if (!checkBatchSafety(batch, state, engine, applied))
+        {
+            // Busca exponencial a partir do início (barata quando o primeiro pedido já é inseguro), depois binária
+            // low: maior prefixo sabidamente aceito (0 vale sempre: nenhum pedido aplicado), high: menor prefixo sabidamente inseguro
+            int low = 0;
+            int high = length;
+            int probe = 1;
+            while (probe < high)
+            {
+                moveToPrefix(state, batch->requests + start, &applied, probe);
+                checks++;
+                if (!checkBatchSafety(batch, state, engine, applied))
+                {
+                    high = probe;
+                    break;
+                }
+                low = probe;
+                probe *= 2;
+            }
+            while (high - low > 1)
+            {
+                int middle = low + (high - low) / 2;
+                moveToPrefix(state, batch->requests + start, &applied, middle);
+                checks++;
+                if (checkBatchSafety(batch, state, engine, applied))
+                {
+                    low = middle;
+                }
+                else
+                {
+                    high = middle;
+                }
+            }
+
+            // Deixa o estado com os low primeiros pedidos aplicados; o pedido seguinte é o negado
+            moveToPrefix(state, batch->requests + start, &applied, low);
+            granted = low;
+            batch->decisions[start + granted] = REQUEST_UNSAFE;
+            stoppedAtLimit = 1;
+        }
+
+        for (int k = 0; k < granted; k++)
+        {
+            batch->decisions[start + k] = REQUEST_GRANTED;
+        }
+        if (engine && granted > 0)
+        {
+            safetyEngineUpdateCustomers(engine, state, batch->changedCustomers, granted);
+        }
+        start += granted + stoppedAtLimit; // Os pedidos depois do negado são decididos de novo a partir do estado atual
+
+        // Só um pedido decidido sozinho pode ter criado ou desfeito uma alocação negativa
+        if (single && granted > 0)
+        {
+            negativeAllocation = engine ? engine->negativeAllocationCount > 0 : hasNegativeAllocation(state);
+        }
+    }
+
+    STATS_ADD(requests, count);
+    for (int k = 0; k < count; k++)
+    {
+        STATS_DECISION(batch->decisions[k]);
+    }
+    batch->count = 0;
+    return checks;
+}
+
+static int hasNegativeValue(const Command *request, int numberOfResources)
+{
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        if (request->resources[j] < 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Aceita e aplica o pedido se ele passa nos limites e no caminho rápido do motor (sem alocação negativa no estado nem
+// valor negativo no pedido). Retorna 0 sem mudar nada se não passa: o pedido vai para a busca por prefixo
+static int admitFastRequest(BankerState *state, SafetyEngine *engine, const Command *request)
+{
+    if (checkRequestLimits(state, request->customerID, request->resources) != REQUEST_GRANTED
+        || !safetyEngineFastApproval(engine, state, request->customerID))
+    {
+        return 0;
+    }
+    applyRequest(state, request, 1);
+    safetyEngineUpdateCustomer(engine, state, request->customerID);
+    return 1;
+}
+
+// Aplica (sign = 1) ou desfaz (sign = -1) um pedido no estado, com as mesmas operações de requestResources
+static void applyRequest(BankerState *state, const Command *request, int sign)
+{
+    int *available = state->availableResources;
+    int *allocation = allocationRow(state, request->customerID);
+    int *need = needRow(state, request->customerID);
+    const int *resources = request->resources;
+
+    if (sign > 0)
+    {
+        for (int j = 0; j < state->numberOfResources; j++)
+        {
+            available[j] -= resources[j];
+            allocation[j] += resources[j];
+            need[j] -= resources[j];
+        }
+    }
+    else
+    {
+        for (int j = 0; j < state->numberOfResources; j++)
+        {
+            available[j] += resources[j];
+            allocation[j] -= resources[j];
+            need[j] += resources[j];
+        }
+    }
+}
+
+// Aplica ou desfaz pedidos até o estado ter exatamente os target primeiros aplicados
+static void moveToPrefix(BankerState *state, const Command *requests, int *applied, int target)
+{
+    while (*applied < target)
+    {
+        applyRequest(state, &requests[(*applied)++], 1);
+    }
+    while (*applied > target)
+    {
+        applyRequest(state, &requests[--(*applied)], -1);
+        STATS_COUNT(rollbacks);
+    }
+}
+
+// Checa o estado com os applied primeiros pedidos do trecho atual aplicados (os clientes deles estão fora de ordem no motor)
+static int checkBatchSafety(RequestBatch *batch, BankerState *state, SafetyEngine *engine, int applied)
+{
+    int safe;
+    STATS_TIMER_START(timer);
+    if (engine)
+    {
+        safe = safetyEngineCheckChanged(engine, state, batch->changedCustomers, applied);
+    }
+    else
+    {
+        safe = checkSafety(state, NULL);
+    }
+    STATS_TIMER_STOP(timer);
+    return safe;
+}
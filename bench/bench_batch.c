@@ -0,0 +1,150 @@
+// Benchmark da admissão em lote: rajadas de pedidos RQ decididos um a um (admitRequest, como requestResources) contra admitRequestBatch
+// Confere que as decisões e o estado final são iguais nos dois caminhos
+// Uso: bench_batch [customers] [resources] [burst] [bursts]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "banker.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Devolve tudo que o cliente tem alocado
+static void releaseAll(BankerState *state, SafetyEngine *engine, int customerID)
+{
+    for (int j = 0; j < state->numberOfResources; j++)
+    {
+        state->availableResources[j] += allocationRow(state, customerID)[j];
+        needRow(state, customerID)[j] += allocationRow(state, customerID)[j];
+        allocationRow(state, customerID)[j] = 0;
+    }
+    safetyEngineUpdateCustomer(engine, state, customerID);
+}
+
+static BankerState* createWorkloadState(int numberOfCustomers, int numberOfResources)
+{
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    srand(42);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            maximumRow(state, i)[j] = rand() % 20;
+            needRow(state, i)[j] = maximumRow(state, i)[j];
+        }
+    }
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        state->availableResources[j] = 3 * numberOfCustomers; // Folgado no começo; as rajadas vão apertando até haver negações
+    }
+    return state;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfCustomers = argc > 1 ? atoi(argv[1]) : 2000;
+    int numberOfResources = argc > 2 ? atoi(argv[2]) : 8;
+    int burst = argc > 3 ? atoi(argv[3]) : 256;
+    int bursts = argc > 4 ? atoi(argv[4]) : 200;
+    long requests = (long)burst * bursts;
+
+    BankerState *serialState = createWorkloadState(numberOfCustomers, numberOfResources);
+    BankerState *batchState = createWorkloadState(numberOfCustomers, numberOfResources);
+    SafetyEngine *serialEngine = createSafetyEngine(serialState);
+    SafetyEngine *batchEngine = createSafetyEngine(batchState);
+    RequestBatch *batch = createRequestBatch(burst, numberOfResources);
+
+    // Gera as rajadas: pedidos pequenos de clientes aleatórios
+    int *customers = (int *)malloc(requests * sizeof(int));
+    int *values = (int *)malloc(requests * numberOfResources * sizeof(int));
+    int releasesPerBurst = burst / 4 > 0 ? burst / 4 : 1;
+    int *releases = (int *)malloc((size_t)bursts * releasesPerBurst * sizeof(int));
+    srand(7);
+    for (long r = 0; r < requests; r++)
+    {
+        customers[r] = rand() % numberOfCustomers;
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            values[r * numberOfResources + j] = rand() % 3;
+        }
+    }
+    for (long r = 0; r < (long)bursts * releasesPerBurst; r++)
+    {
+        releases[r] = rand() % numberOfCustomers;
+    }
+
+    RequestDecision *serialDecisions = (RequestDecision *)malloc(requests * sizeof(RequestDecision));
+    RequestDecision *batchDecisions = (RequestDecision *)malloc(requests * sizeof(RequestDecision));
+    long serialChecks = 0;
+    long batchChecks = 0;
+    long granted = 0;
+
+    // Um a um
+    double start = nowSeconds();
+    for (int b = 0; b < bursts; b++)
+    {
+        for (int k = 0; k < burst; k++)
+        {
+            long r = (long)b * burst + k;
+            serialDecisions[r] = admitRequest(serialState, serialEngine, customers[r], values + r * numberOfResources);
+            serialChecks += serialDecisions[r] == REQUEST_GRANTED || serialDecisions[r] == REQUEST_UNSAFE; // Passou dos limites
+        }
+        for (int k = 0; k < releasesPerBurst; k++) // Algumas liberações entre as rajadas
+        {
+            releaseAll(serialState, serialEngine, releases[(long)b * releasesPerBurst + k]);
+        }
+    }
+    double serialTime = nowSeconds() - start;
+
+    // Em lote
+    start = nowSeconds();
+    for (int b = 0; b < bursts; b++)
+    {
+        for (int k = 0; k < burst; k++)
+        {
+            long r = (long)b * burst + k;
+            addBatchRequest(batch, customers[r], values + r * numberOfResources);
+        }
+        batchChecks += admitRequestBatch(batch, batchState, batchEngine);
+        memcpy(batchDecisions + (long)b * burst, batch->decisions, burst * sizeof(RequestDecision));
+        for (int k = 0; k < releasesPerBurst; k++)
+        {
+            releaseAll(batchState, batchEngine, releases[(long)b * releasesPerBurst + k]);
+        }
+    }
+    double batchTime = nowSeconds() - start;
+
+    // Confere decisões e estado final
+    long mismatches = 0;
+    for (long r = 0; r < requests; r++)
+    {
+        mismatches += serialDecisions[r] != batchDecisions[r];
+        granted += serialDecisions[r] == REQUEST_GRANTED;
+    }
+    size_t matrixBytes = (size_t)numberOfCustomers * serialState->rowStride * sizeof(int);
+    mismatches += memcmp(serialState->currentAllocation, batchState->currentAllocation, matrixBytes) != 0;
+    mismatches += memcmp(serialState->availableResources, batchState->availableResources, numberOfResources * sizeof(int)) != 0;
+
+    printf("%d customers x %d resources, %d bursts of %d requests (%.1f%% granted)\n", numberOfCustomers, numberOfResources, bursts, burst, 100.0 * granted / requests);
+    printf("%-12s %14s %12s %14s\n", "admission", "safety checks", "ms", "ns/request");
+    printf("%-12s %14ld %12.2f %14.1f\n", "one by one", serialChecks, serialTime * 1e3, serialTime * 1e9 / requests);
+    printf("%-12s %14ld %12.2f %14.1f\n", "batch", batchChecks, batchTime * 1e3, batchTime * 1e9 / requests);
+    printf("speedup %.2fx, mismatches: %ld\n", serialTime / batchTime, mismatches);
+
+    free(customers);
+    free(values);
+    free(releases);
+    free(serialDecisions);
+    free(batchDecisions);
+    destroyRequestBatch(batch);
+    destroySafetyEngine(serialEngine);
+    destroySafetyEngine(batchEngine);
+    destroyBankerState(serialState);
+    destroyBankerState(batchState);
+    return mismatches != 0;
+}
@@ -0,0 +1,142 @@
+// Benchmark do cache da sequência segura no motor incremental, em cargas sintéticas realistas (workload.c)
+// Cada carga roda três vezes com admitRequest/admitRelease: checkSafety completo, o motor sem a sequência guardada
+// (descartada antes de cada pedido) e o motor normal. Mostra o custo por checagem e quantas checagens foram resolvidas
+// pelo caminho rápido, pela sequência guardada ou com reparo. Termina com erro se as decisões dos três não forem iguais
+// Uso: bench_cache [opções da carga, ver bench_generate]   (sem opções roda um conjunto fixo de cargas)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "workload.h"
+
+typedef enum
+{
+    MODE_FULL,    // checkSafety em todo pedido
+    MODE_NOCACHE, // Motor incremental sem reaproveitar a sequência segura
+    MODE_CACHED   // Motor incremental normal
+} CacheMode;
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Executa a carga num modo, guardando a decisão de cada comando em decisions. Retorna os ns por checagem de segurança
+static double runMode(const Workload *workload, CacheMode mode, RequestDecision *decisions, SafetyEngine *counters)
+{
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = mode == MODE_FULL ? NULL : createSafetyEngine(state);
+    long checks = 0;
+    double checkTime = 0;
+
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = &workload->commands[k];
+        decisions[k] = REQUEST_GRANTED;
+        if (command->type == COMMAND_RELEASE)
+        {
+            decisions[k] = admitRelease(state, engine, command->customerID, command->resources) ? REQUEST_GRANTED : REQUEST_EXCEEDS_NEED;
+        }
+        else if (command->type == COMMAND_REQUEST)
+        {
+            decisions[k] = checkRequestLimits(state, command->customerID, command->resources);
+            if (decisions[k] != REQUEST_GRANTED)
+            {
+                continue;
+            }
+            if (mode == MODE_NOCACHE)
+            {
+                engine->hasSafeSequence = 0;
+            }
+            double start = nowSeconds();
+            decisions[k] = admitRequest(state, engine, command->customerID, command->resources);
+            checkTime += nowSeconds() - start;
+            checks++;
+        }
+    }
+
+    if (engine)
+    {
+        *counters = *engine;
+    }
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    return checks ? checkTime * 1e9 / checks : 0.0;
+}
+
+static int runWorkload(const WorkloadOptions *options)
+{
+    Workload *workload = createWorkload(options);
+    if (!workload)
+    {
+        printf("Unable to generate the workload\n");
+        return 1;
+    }
+
+    RequestDecision *expected = (RequestDecision *)malloc((workload->count + 1) * sizeof(RequestDecision));
+    RequestDecision *decisions = (RequestDecision *)malloc((workload->count + 1) * sizeof(RequestDecision));
+    SafetyEngine nocache;
+    SafetyEngine cached;
+    double fullNs = runMode(workload, MODE_FULL, expected, &cached);
+    double nocacheNs = runMode(workload, MODE_NOCACHE, decisions, &nocache);
+    long mismatches = 0;
+    for (long k = 0; k < workload->count; k++)
+    {
+        mismatches += decisions[k] != expected[k];
+    }
+    double cachedNs = runMode(workload, MODE_CACHED, decisions, &cached);
+    for (long k = 0; k < workload->count; k++)
+    {
+        mismatches += decisions[k] != expected[k];
+    }
+
+    long checks = cached.fastApprovals + cached.cacheHits + cached.cacheMisses + cached.fullChecks;
+    printf("%9d %9d %5.2f %6.2f %7.2f %11.0f %11.0f %11.0f %7.1f%% %7.1f%% %7.1f%% %9ld\n",
+           options->numberOfCustomers, options->numberOfResources, options->skew, options->unsafeShare, options->releaseShare,
+           fullNs, nocacheNs, cachedNs, checks ? 100.0 * cached.fastApprovals / checks : 0.0,
+           checks ? 100.0 * cached.cacheHits / checks : 0.0, checks ? 100.0 * cached.cacheMisses / checks : 0.0, mismatches);
+
+    free(expected);
+    free(decisions);
+    destroyWorkload(workload);
+    return mismatches != 0;
+}
+
+int main(int argc, char *argv[])
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    setvbuf(stdout, NULL, _IOLBF, 0); // Uma linha por carga assim que termina
+    options.numberOfCommands = 5000; // checkSafety completo custa ~0,5 ms por pedido com 1000 clientes
+    for (int i = 1; i < argc; i++)
+    {
+        if (!parseWorkloadOption(&options, argv[i]))
+        {
+            printf("Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    printf("%9s %9s %5s %6s %7s %11s %11s %11s %8s %8s %8s %9s\n", "customers", "resources", "skew", "unsafe", "release",
+           "full ns", "nocache ns", "cached ns", "fast", "hit", "miss", "mismatch");
+    if (argc > 1)
+    {
+        return runWorkload(&options);
+    }
+
+    // Uniforme, com clientes quentes, com mais liberações, com mais pedidos inseguros e com mais recursos
+    int failed = 0;
+    const double shapes[][3] = { { 0.0, 0.05, 0.3 }, { 0.5, 0.05, 0.3 }, { 0.0, 0.05, 0.5 }, { 0.0, 0.3, 0.3 }, { 0.5, 0.3, 0.2 } };
+    for (int s = 0; s < 5; s++)
+    {
+        options.skew = shapes[s][0];
+        options.unsafeShare = shapes[s][1];
+        options.releaseShare = shapes[s][2];
+        failed |= runWorkload(&options);
+    }
+    options.numberOfResources = 16;
+    options.numberOfCustomers = 2000;
+    failed |= runWorkload(&options);
+    return failed;
+}
@@ -0,0 +1,125 @@
+// Benchmark do checkpoint binário (snapshot.c): recomeçar depois de uma carga longa refazendo todos os comandos contra
+// carregar o checkpoint gravado no fim dela (loadCheckpoint e a criação do motor incremental)
+// Mostra o tempo de refazer a carga, de gravar e de carregar o checkpoint, e confere que o estado carregado é o mesmo
+// Uso: bench_checkpoint [opções da carga, ver bench_generate] [file=PATH]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "workload.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Refaz a carga inteira a partir do estado inicial, como um recomeço sem checkpoint
+static BankerState* replayWorkload(const Workload *workload)
+{
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = createSafetyEngine(state);
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = &workload->commands[k];
+        if (command->type == COMMAND_REQUEST)
+        {
+            admitRequest(state, engine, command->customerID, command->resources);
+        }
+        else if (command->type == COMMAND_RELEASE)
+        {
+            admitRelease(state, engine, command->customerID, command->resources);
+        }
+    }
+    destroySafetyEngine(engine);
+    return state;
+}
+
+// Linhas diferentes entre dois estados (máximo, alocação e NEED) mais os disponíveis
+static long compareStates(const BankerState *expected, const BankerState *state)
+{
+    if (state->numberOfCustomers != expected->numberOfCustomers || state->numberOfResources != expected->numberOfResources)
+    {
+        return 1;
+    }
+    size_t bytes = expected->numberOfResources * sizeof(int);
+    long mismatches = memcmp(state->availableResources, expected->availableResources, bytes) != 0;
+    for (int i = 0; i < expected->numberOfCustomers; i++)
+    {
+        mismatches += memcmp(maximumRow(state, i), maximumRow(expected, i), bytes) != 0
+                      || memcmp(allocationRow(state, i), allocationRow(expected, i), bytes) != 0
+                      || memcmp(needRow(state, i), needRow(expected, i), bytes) != 0;
+    }
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    options.numberOfCustomers = 10000;
+    options.numberOfCommands = 100000;
+    const char *filename = "/tmp/bench_checkpoint.bin";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "file=", 5) == 0)
+        {
+            filename = argv[i] + 5;
+        }
+        else if (!parseWorkloadOption(&options, argv[i]))
+        {
+            printf("Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Workload *workload = createWorkload(&options);
+    if (!workload)
+    {
+        printf("Unable to generate the workload\n");
+        return 1;
+    }
+
+    double start = nowSeconds();
+    BankerState *expected = replayWorkload(workload);
+    double replayTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    int saved = saveCheckpoint(filename, expected, (unsigned long long)workload->count, 0);
+    double saveTime = nowSeconds() - start;
+    if (!saved)
+    {
+        printf("Unable to write %s\n", filename);
+        return 1;
+    }
+
+    unsigned long long sequence = 0;
+    const char *error = NULL;
+    start = nowSeconds();
+    BankerState *state = loadCheckpoint(filename, &sequence, NULL, &error);
+    double loadTime = nowSeconds() - start;
+    if (!state)
+    {
+        printf("%s: %s\n", filename, error);
+        return 1;
+    }
+    start = nowSeconds();
+    SafetyEngine *engine = createSafetyEngine(state);
+    double engineTime = nowSeconds() - start;
+
+    long mismatches = compareStates(expected, state) + (sequence != (unsigned long long)workload->count);
+    printf("%d customers, %d resources, %ld commands\n", options.numberOfCustomers, options.numberOfResources, workload->count);
+    printf("%-28s %10.1f ms\n", "replay all commands", replayTime * 1e3);
+    printf("%-28s %10.1f ms\n", "save checkpoint (fsync)", saveTime * 1e3);
+    printf("%-28s %10.1f ms\n", "load checkpoint", loadTime * 1e3);
+    printf("%-28s %10.1f ms\n", "load + safety engine", (loadTime + engineTime) * 1e3);
+    printf("restart speedup %.1fx, mismatches %ld\n", replayTime / (loadTime + engineTime), mismatches);
+
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    destroyBankerState(expected);
+    destroyWorkload(workload);
+    remove(filename);
+    return mismatches != 0;
+}
@@ -0,0 +1,160 @@
+// Benchmark do estado compacto (compact.c) contra o BankerState com o motor incremental, numa carga sintética grande
+// Mostra os bytes por cliente de cada um (matrizes e vetores por cliente do motor) e os ns por comando
+// Termina com erro se as decisões (RQ e RL) não forem iguais
+// Uso: bench_compact [customers] [resources] [commands] [seed]   (sem argumentos roda 10000 clientes com 32 e 8 recursos)
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "workload.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Bytes do BankerState (três matrizes com padding) e dos vetores por cliente do SafetyEngine
+static size_t regularStateBytes(const BankerState *state)
+{
+    size_t customers = state->numberOfCustomers;
+    size_t engineInts = 7 + 2 * (size_t)state->numberOfResources; // Sequências, marcas, fila e order/rank por recurso
+    return customers * (3 * (size_t)state->rowStride + engineInts) * sizeof(int);
+}
+
+// Executa a carga com admitRequest/admitRelease. Retorna os ns por comando
+static double runRegular(const Workload *workload, RequestDecision *decisions, size_t *bytes)
+{
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = createSafetyEngine(state);
+    *bytes = regularStateBytes(state);
+
+    double start = nowSeconds();
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = &workload->commands[k];
+        decisions[k] = REQUEST_GRANTED;
+        if (command->type == COMMAND_REQUEST)
+        {
+            decisions[k] = admitRequest(state, engine, command->customerID, command->resources);
+        }
+        else if (command->type == COMMAND_RELEASE)
+        {
+            decisions[k] = admitRelease(state, engine, command->customerID, command->resources) ? REQUEST_GRANTED : REQUEST_EXCEEDS_NEED;
+        }
+    }
+    double elapsed = nowSeconds() - start;
+
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    return workload->count ? elapsed * 1e9 / workload->count : 0.0;
+}
+
+// A mesma carga com compactAdmitRequest/compactAdmitRelease. Retorna os ns por comando (negativo se alguma alocação não coube)
+static double runCompact(const Workload *workload, RequestDecision *decisions, size_t *bytes)
+{
+    const BankerState *initial = workload->initial;
+    int numberOfResources = initial->numberOfResources;
+    int columnMaximum[numberOfResources + 1];
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        columnMaximum[j] = 0;
+        for (int i = 0; i < initial->numberOfCustomers; i++)
+        {
+            if (maximumRow(initial, i)[j] > columnMaximum[j])
+            {
+                columnMaximum[j] = maximumRow(initial, i)[j];
+            }
+        }
+    }
+    CompactState *state = createCompactState(initial->numberOfCustomers, numberOfResources, columnMaximum);
+    for (int i = 0; i < initial->numberOfCustomers; i++)
+    {
+        setCompactMaximumRow(state, i, maximumRow(initial, i));
+    }
+    setCompactAvailable(state, initial->availableResources);
+    *bytes = compactStateBytes(state);
+
+    int ok = 1;
+    double start = nowSeconds();
+    for (long k = 0; k < workload->count && ok; k++)
+    {
+        const Command *command = &workload->commands[k];
+        decisions[k] = REQUEST_GRANTED;
+        if (command->type == COMMAND_REQUEST)
+        {
+            ok = compactAdmitRequest(state, command->customerID, command->resources, &decisions[k]);
+        }
+        else if (command->type == COMMAND_RELEASE)
+        {
+            int released;
+            ok = compactAdmitRelease(state, command->customerID, command->resources, &released);
+            decisions[k] = released ? REQUEST_GRANTED : REQUEST_EXCEEDS_NEED;
+        }
+    }
+    double elapsed = nowSeconds() - start;
+
+    destroyCompactState(state);
+    if (!ok)
+    {
+        return -1.0;
+    }
+    return workload->count ? elapsed * 1e9 / workload->count : 0.0;
+}
+
+static int runWorkload(int numberOfCustomers, int numberOfResources, long numberOfCommands, unsigned long seed)
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    options.numberOfCustomers = numberOfCustomers;
+    options.numberOfResources = numberOfResources;
+    options.numberOfCommands = numberOfCommands;
+    options.seed = seed;
+    Workload *workload = createWorkload(&options);
+    if (!workload)
+    {
+        printf("Unable to generate the workload\n");
+        return 1;
+    }
+
+    RequestDecision *expected = (RequestDecision *)malloc((workload->count + 1) * sizeof(RequestDecision));
+    RequestDecision *decisions = (RequestDecision *)malloc((workload->count + 1) * sizeof(RequestDecision));
+    size_t regularBytes;
+    size_t compactBytes;
+    double regularNs = runRegular(workload, expected, &regularBytes);
+    double compactNs = runCompact(workload, decisions, &compactBytes);
+
+    long mismatches = compactNs < 0 ? 1 : 0;
+    for (long k = 0; k < workload->count && compactNs >= 0; k++)
+    {
+        mismatches += decisions[k] != expected[k];
+    }
+
+    printf("%9d %9d %14.1f %14.1f %7.2fx %11.0f %11.0f %9ld\n", numberOfCustomers, numberOfResources,
+           (double)regularBytes / numberOfCustomers, (double)compactBytes / numberOfCustomers,
+           (double)regularBytes / compactBytes, regularNs, compactNs, mismatches);
+
+    free(expected);
+    free(decisions);
+    destroyWorkload(workload);
+    return mismatches != 0;
+}
+
+int main(int argc, char *argv[])
+{
+    setvbuf(stdout, NULL, _IOLBF, 0); // Uma linha por carga assim que termina
+    printf("%9s %9s %14s %14s %8s %11s %11s %9s\n", "customers", "resources", "int B/cust", "compact B/cust",
+           "ratio", "int ns/cmd", "compact ns", "mismatch");
+    if (argc > 1)
+    {
+        int numberOfCustomers = atoi(argv[1]);
+        int numberOfResources = argc > 2 ? atoi(argv[2]) : 32;
+        long numberOfCommands = argc > 3 ? atol(argv[3]) : 20000;
+        unsigned long seed = argc > 4 ? strtoul(argv[4], NULL, 10) : 42;
+        return runWorkload(numberOfCustomers, numberOfResources, numberOfCommands, seed);
+    }
+
+    int failed = runWorkload(10000, 32, 20000, 42);
+    failed |= runWorkload(10000, 8, 20000, 42);
+    return failed;
+}
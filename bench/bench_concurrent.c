@@ -0,0 +1,198 @@
+// Stress do núcleo concorrente: T threads mandando RQ/RL sobre os mesmos clientes, de 1 a N threads
+// Cada decisão guarda o número tirado no ponto de linearização; depois os comandos são refeitos em série nessa ordem com
+// admitRequest/admitRelease e as decisões e o estado final têm que ser iguais (senão termina com erro)
+// Uso: bench_concurrent [customers] [resources] [maxThreads] [commandsPerThread]
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "banker.h"
+
+typedef struct
+{
+    long order;      // Posição na ordem de linearização
+    int customerID;
+    int isRequest;
+    int decision;    // RequestDecision no RQ, 1/0 no RL
+    int thread;
+    int index;       // Posição do comando na lista da thread (os valores ficam em values)
+} LoggedCommand;
+
+typedef struct
+{
+    ConcurrentBanker *banker;
+    ConcurrentWorker *worker;
+    int thread;
+    int commands;
+    int numberOfCustomers;
+    int numberOfResources;
+    int *values;            // commands x numberOfResources
+    LoggedCommand *log;
+} StressThread;
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static BankerState* createStressState(int numberOfCustomers, int numberOfResources)
+{
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    srand(42);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            maximumRow(state, i)[j] = rand() % 20;
+            needRow(state, i)[j] = maximumRow(state, i)[j];
+        }
+    }
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        state->availableResources[j] = 4 * numberOfCustomers; // Aperta com o tempo: há negações por NEED, disponíveis e segurança
+    }
+    return state;
+}
+
+static void* runStressThread(void *argument)
+{
+    StressThread *stress = (StressThread *)argument;
+    unsigned seed = 777u * (stress->thread + 1);
+
+    for (int k = 0; k < stress->commands; k++)
+    {
+        LoggedCommand *entry = &stress->log[k];
+        int *values = stress->values + (size_t)k * stress->numberOfResources;
+        entry->customerID = rand_r(&seed) % stress->numberOfCustomers; // Todas as threads disputam os mesmos clientes
+        entry->isRequest = rand_r(&seed) % 100 < 65;
+        entry->thread = stress->thread;
+        entry->index = k;
+        for (int j = 0; j < stress->numberOfResources; j++)
+        {
+            values[j] = rand_r(&seed) % (entry->isRequest ? 4 : 3);
+            if (rand_r(&seed) % 500 == 0)
+            {
+                values[j] = -1; // Valores negativos também são aceitos pelo parser e passam pelo caminho estrito
+            }
+        }
+
+        if (entry->isRequest)
+        {
+            entry->decision = concurrentRequest(stress->worker, entry->customerID, values, &entry->order);
+        }
+        else
+        {
+            entry->decision = concurrentRelease(stress->banker, entry->customerID, values, &entry->order);
+        }
+    }
+    return NULL;
+}
+
+static int compareOrder(const void *a, const void *b)
+{
+    long x = ((const LoggedCommand *)a)->order;
+    long y = ((const LoggedCommand *)b)->order;
+    return (x > y) - (x < y);
+}
+
+// Roda uma rodada com numberOfThreads threads e confere contra a execução serial. Retorna o número de divergências
+static long runRound(int numberOfThreads, int numberOfCustomers, int numberOfResources, int commandsPerThread, double *baseline)
+{
+    BankerState *state = createStressState(numberOfCustomers, numberOfResources);
+    ConcurrentBanker *banker = createConcurrentBanker(state);
+    StressThread *threads = (StressThread *)calloc(numberOfThreads, sizeof(StressThread));
+    pthread_t *handles = (pthread_t *)malloc(numberOfThreads * sizeof(pthread_t));
+    long total = (long)numberOfThreads * commandsPerThread;
+    LoggedCommand *log = (LoggedCommand *)malloc(total * sizeof(LoggedCommand));
+
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+        threads[t].banker = banker;
+        threads[t].worker = createConcurrentWorker(banker);
+        threads[t].thread = t;
+        threads[t].commands = commandsPerThread;
+        threads[t].numberOfCustomers = numberOfCustomers;
+        threads[t].numberOfResources = numberOfResources;
+        threads[t].values = (int *)malloc((size_t)commandsPerThread * numberOfResources * sizeof(int));
+        threads[t].log = log + (long)t * commandsPerThread;
+    }
+
+    double start = nowSeconds();
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+        pthread_create(&handles[t], NULL, runStressThread, &threads[t]);
+    }
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+        pthread_join(handles[t], NULL);
+    }
+    double elapsed = nowSeconds() - start;
+
+    // Refaz em série na ordem de linearização
+    BankerState *serial = createStressState(numberOfCustomers, numberOfResources);
+    qsort(log, total, sizeof(LoggedCommand), compareOrder);
+    long mismatches = 0;
+    long granted = 0;
+    long conflicts = 0;
+    long snapshotRetries = 0;
+    for (long r = 0; r < total; r++)
+    {
+        const LoggedCommand *entry = &log[r];
+        const int *values = threads[entry->thread].values + (size_t)entry->index * numberOfResources;
+        int decision = entry->isRequest ? (int)admitRequest(serial, NULL, entry->customerID, values)
+                                        : admitRelease(serial, NULL, entry->customerID, values);
+        mismatches += decision != entry->decision;
+        granted += entry->isRequest && entry->decision == REQUEST_GRANTED;
+    }
+    size_t matrixBytes = (size_t)numberOfCustomers * state->rowStride * sizeof(int);
+    mismatches += memcmp(serial->currentAllocation, state->currentAllocation, matrixBytes) != 0;
+    mismatches += memcmp(serial->remainingNeed, state->remainingNeed, matrixBytes) != 0;
+    mismatches += memcmp(serial->availableResources, state->availableResources, numberOfResources * sizeof(int)) != 0;
+
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+        conflicts += threads[t].worker->conflicts;
+        snapshotRetries += threads[t].worker->snapshotRetries;
+        destroyConcurrentWorker(threads[t].worker);
+        free(threads[t].values);
+    }
+
+    double rate = total / elapsed;
+    if (numberOfThreads == 1)
+    {
+        *baseline = rate;
+    }
+    printf("%7d %14.0f %9.2f %9.1f%% %10ld %10ld %10ld\n", numberOfThreads, rate, rate / *baseline, 100.0 * granted / total,
+           conflicts, snapshotRetries, mismatches);
+
+    free(log);
+    free(handles);
+    free(threads);
+    destroyConcurrentBanker(banker);
+    destroyBankerState(state);
+    destroyBankerState(serial);
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfCustomers = argc > 1 ? atoi(argv[1]) : 256;
+    int numberOfResources = argc > 2 ? atoi(argv[2]) : 8;
+    int maxThreads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int commandsPerThread = argc > 4 ? atoi(argv[4]) : 20000;
+
+    printf("%d customers x %d resources, %d commands per thread (65%% RQ, 35%% RL)\n", numberOfCustomers, numberOfResources, commandsPerThread);
+    printf("%7s %14s %9s %10s %10s %10s %10s\n", "threads", "commands/s", "scaling", "granted", "conflicts", "retries", "mismatches");
+
+    double baseline = 0;
+    long mismatches = 0;
+    for (int threads = 1; threads <= (maxThreads > 1 ? maxThreads : 2); threads *= 2)
+    {
+        mismatches += runRound(threads, numberOfCustomers, numberOfResources, commandsPerThread, &baseline);
+    }
+    return mismatches != 0;
+}
@@ -0,0 +1,197 @@
+// Benchmark do banqueiro numa carga sintética (workload.c), com o resultado numa linha JSON para comparar entre mudanças
+// Executa os comandos em processo com admitRequest/admitRelease (comandos/s, ns por checagem de segurança, pico de RSS) e,
+// com cli=PATH, também roda o ./banker de verdade sobre os arquivos gerados (tempo de ponta a ponta e pico de RSS do processo)
+// Termina com erro se os pedidos negados por segurança não forem os que o gerador previu
+// Uso: bench_engine [opções da carga, ver bench_generate] [engine=incremental|full] [cli=PATH] [dir=PATH]
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "workload.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Roda o banker em directory com os recursos disponíveis da carga. Retorna o status de saída, ou -1 se não rodou
+static int runCommandLine(const char *program, const char *directory, const Workload *workload, double *seconds, long *peakRss)
+{
+    int numberOfResources = workload->initial->numberOfResources;
+    char **arguments = (char **)calloc(numberOfResources + 2, sizeof(char *));
+    char *numbers = (char *)malloc((size_t)numberOfResources * 16);
+    arguments[0] = (char *)program;
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        arguments[j + 1] = numbers + (size_t)j * 16;
+        snprintf(arguments[j + 1], 16, "%d", workload->initial->availableResources[j]);
+    }
+
+    fflush(stdout); // Senão o filho herda e repete o que está no buffer
+    double start = nowSeconds();
+    pid_t child = fork();
+    if (child == 0)
+    {
+        if (chdir(directory) != 0 || !freopen("/dev/null", "w", stdout))
+        {
+            _exit(127);
+        }
+        execv(program, arguments);
+        _exit(127);
+    }
+
+    int status = -1;
+    struct rusage usage;
+    if (child < 0 || wait4(child, &status, 0, &usage) < 0)
+    {
+        free(arguments);
+        free(numbers);
+        return -1;
+    }
+    *seconds = nowSeconds() - start;
+    *peakRss = usage.ru_maxrss;
+    free(arguments);
+    free(numbers);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void removeWorkloadFiles(const char *directory)
+{
+    const char *names[] = { "customer.txt", "commands.txt", "args", "result.txt" };
+    char path[PATH_MAX + 32];
+    for (int k = 0; k < 4; k++)
+    {
+        snprintf(path, sizeof(path), "%s/%s", directory, names[k]);
+        unlink(path);
+    }
+    rmdir(directory);
+}
+
+int main(int argc, char *argv[])
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    const char *engineName = "incremental";
+    const char *commandLine = NULL;
+    const char *directory = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "engine=", 7) == 0 && (strcmp(argv[i] + 7, "incremental") == 0 || strcmp(argv[i] + 7, "full") == 0))
+        {
+            engineName = argv[i] + 7;
+        }
+        else if (strncmp(argv[i], "cli=", 4) == 0)
+        {
+            commandLine = argv[i] + 4;
+        }
+        else if (strncmp(argv[i], "dir=", 4) == 0)
+        {
+            directory = argv[i] + 4;
+        }
+        else if (!parseWorkloadOption(&options, argv[i]))
+        {
+            printf("Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    double start = nowSeconds();
+    Workload *workload = createWorkload(&options);
+    if (!workload)
+    {
+        printf("Unable to generate the workload\n");
+        return 1;
+    }
+    double generateTime = nowSeconds() - start;
+
+    // Em processo
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = strcmp(engineName, "incremental") == 0 ? createSafetyEngine(state) : NULL;
+    OutputWriter *snapshot = openMemoryWriter(4096);
+    long checks = 0;
+    long unsafeDenials = 0;
+    double checkTime = 0;
+
+    start = nowSeconds();
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = &workload->commands[k];
+        if (command->type == COMMAND_PRINT)
+        {
+            writeStateSnapshot(snapshot, state);
+            snapshot->length = 0;
+        }
+        else if (command->type == COMMAND_RELEASE)
+        {
+            admitRelease(state, engine, command->customerID, command->resources);
+        }
+        else if (checkRequestLimits(state, command->customerID, command->resources) == REQUEST_GRANTED)
+        {
+            // Só os pedidos que passam nos limites chegam à checagem de segurança
+            double checkStart = nowSeconds();
+            RequestDecision decision = admitRequest(state, engine, command->customerID, command->resources);
+            checkTime += nowSeconds() - checkStart;
+            checks++;
+            unsafeDenials += decision == REQUEST_UNSAFE;
+        }
+    }
+    double runTime = nowSeconds() - start;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("{\"bench\":\"engine\",\"engine\":\"%s\",\"customers\":%d,\"resources\":%d,\"commands\":%ld,"
+           "\"skew\":%g,\"unsafe\":%g,\"release\":%g,\"seed\":%lu,\"generateSeconds\":%.3f,"
+           "\"commandsPerSecond\":%.0f,\"safetyChecks\":%ld,\"nsPerCheck\":%.1f,\"unsafeDenials\":%ld,\"overNeedRequests\":%ld,\"peakRssKiB\":%ld",
+           engineName, options.numberOfCustomers, options.numberOfResources, workload->count,
+           options.skew, options.unsafeShare, options.releaseShare, options.seed, generateTime,
+           workload->count / runTime, checks, checks ? checkTime * 1e9 / checks : 0.0, unsafeDenials, workload->overNeedRequests, usage.ru_maxrss);
+
+    // De ponta a ponta com o ./banker
+    int status = 0;
+    if (commandLine)
+    {
+        char program[PATH_MAX];
+        char temporary[] = "/tmp/bench_engine_XXXXXX";
+        const char *target = directory ? directory : mkdtemp(temporary);
+        double seconds = 0;
+        long peakRss = 0;
+        if (!realpath(commandLine, program) || !target || !writeWorkloadFiles(workload, target))
+        {
+            status = -1;
+        }
+        else
+        {
+            status = runCommandLine(program, target, workload, &seconds, &peakRss);
+        }
+        printf(",\"cliStatus\":%d,\"cliSeconds\":%.3f,\"cliCommandsPerSecond\":%.0f,\"cliPeakRssKiB\":%ld",
+               status, seconds, seconds > 0 ? workload->count / seconds : 0.0, peakRss);
+        if (!directory && target)
+        {
+            removeWorkloadFiles(target);
+        }
+    }
+    else if (directory && !writeWorkloadFiles(workload, directory))
+    {
+        status = -1;
+    }
+    printf("}\n");
+
+    int mismatch = unsafeDenials != workload->unsafeRequests;
+    if (mismatch)
+    {
+        fprintf(stderr, "unsafe denials %ld, generator expected %ld\n", unsafeDenials, workload->unsafeRequests);
+    }
+
+    closeOutputWriter(snapshot);
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    destroyWorkload(workload);
+    return mismatch || status != 0;
+}
@@ -0,0 +1,36 @@
+// Gera uma carga sintética em disco: customer.txt, commands.txt e args (recursos disponíveis para ./banker)
+// Uso: bench_generate <dir> [customers=N] [resources=N] [commands=N] [skew=F] [unsafe=F] [release=F] [print=F] [seed=N]
+// Ex.: bench_generate /tmp/w customers=5000 commands=1000000 && cd /tmp/w && ./banker $(cat args)
+#include <stdio.h>
+#include "workload.h"
+
+int main(int argc, char *argv[])
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    if (argc < 2)
+    {
+        printf("Usage: bench_generate <dir> [customers=N] [resources=N] [commands=N] [skew=F] [unsafe=F] [release=F] [print=F] [seed=N]\n");
+        return 1;
+    }
+    for (int i = 2; i < argc; i++)
+    {
+        if (!parseWorkloadOption(&options, argv[i]))
+        {
+            printf("Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Workload *workload = createWorkload(&options);
+    if (!workload || !writeWorkloadFiles(workload, argv[1]))
+    {
+        printf("Unable to write the workload to %s\n", argv[1]);
+        destroyWorkload(workload);
+        return 1;
+    }
+    printf("%ld commands for %d customers x %d resources in %s (%ld unsafe RQ, %ld over-need RQ)\n", workload->count,
+           options.numberOfCustomers, options.numberOfResources, argv[1], workload->unsafeRequests, workload->overNeedRequests);
+    destroyWorkload(workload);
+    return 0;
+}
@@ -0,0 +1,259 @@
+// Microbenchmark: matrizes com um malloc por linha (int **) contra o BankerState contíguo
+// Uso: bench_layout [customers] [resources] [passes]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "banker.h"
+
+#define CHECK_REPEATS 5
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Layout antigo: um malloc por linha, como allocate2DMatrix fazia
+static int** allocate2DMatrix(int rows, int cols)
+{
+    int **matrix = (int **)malloc(rows * sizeof(int *));
+    for (int i = 0; i < rows; i++)
+    {
+        matrix[i] = (int *)calloc(cols, sizeof(int));
+    }
+    return matrix;
+}
+
+// Layout antigo num heap já fragmentado (processo de longa duração): as linhas ficam espalhadas
+// entre blocos de outros tamanhos, e a ordem das linhas na memória não segue a ordem dos clientes
+static int** allocateFragmented2DMatrix(int rows, int cols, void **spacers)
+{
+    int **matrix = (int **)malloc(rows * sizeof(int *));
+    for (int i = 0; i < rows; i++)
+    {
+        spacers[i] = malloc(16 + rand() % 512);
+        matrix[i] = (int *)calloc(cols, sizeof(int));
+    }
+    for (int i = rows - 1; i > 0; i--)
+    {
+        int k = rand() % (i + 1);
+        int *row = matrix[i];
+        matrix[i] = matrix[k];
+        matrix[k] = row;
+    }
+    return matrix;
+}
+
+static void free2DMatrix(int **matrix, int rows)
+{
+    for (int i = 0; i < rows; i++)
+    {
+        free(matrix[i]);
+    }
+    free(matrix);
+}
+
+// checkSafety como era antes, sobre int **
+static int checkSafetyPointerRows(int **currentAllocation, int **remainingNeed, int *availableResources, int numberOfCustomers, int numberOfResources)
+{
+    int finished[numberOfCustomers];
+    int work[numberOfResources];
+
+    memcpy(work, availableResources, numberOfResources * sizeof(int));
+    memset(finished, 0, numberOfCustomers * sizeof(int));
+
+    for (int k = 0; k < numberOfCustomers; k++)
+    {
+        for (int i = 0; i < numberOfCustomers; i++)
+        {
+            if (!finished[i])
+            {
+                int j;
+                for (j = 0; j < numberOfResources; j++)
+                {
+                    if (remainingNeed[i][j] > work[j])
+                    {
+                        break;
+                    }
+                }
+                if (j == numberOfResources)
+                {
+                    for (j = 0; j < numberOfResources; j++)
+                    {
+                        work[j] += currentAllocation[i][j];
+                    }
+                    finished[i] = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        if (!finished[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Uma varredura completa dos candidatos em que a NEED só deixa de caber na última coluna (lê a linha inteira)
+static int scanPointerRows(int **remainingNeed, const int *work, int numberOfCustomers, int numberOfResources)
+{
+    int fits = 0;
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        int j;
+        for (j = 0; j < numberOfResources; j++)
+        {
+            if (remainingNeed[i][j] > work[j])
+            {
+                break;
+            }
+        }
+        fits += j == numberOfResources;
+    }
+    return fits;
+}
+
+static int scanContiguous(const BankerState *state, const int *work)
+{
+    int fits = 0;
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        const int *need = needRow(state, i);
+        int j;
+        for (j = 0; j < state->numberOfResources; j++)
+        {
+            if (need[j] > work[j])
+            {
+                break;
+            }
+        }
+        fits += j == state->numberOfResources;
+    }
+    return fits;
+}
+
+// Preenche o estado em que os clientes só podem terminar em ordem decrescente: o cliente i precisa de
+// numberOfCustomers - 1 - i unidades a mais do recurso 0, e cada cliente que termina devolve 1 unidade
+// Assim checkSafety faz ~n²/2 testes que falham na primeira coluna, o pior caso para o acesso às linhas
+static void fillWorstOrder(int **currentAllocation, int **remainingNeed, BankerState *state)
+{
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        for (int j = 0; j < state->numberOfResources; j++)
+        {
+            int allocation = 1;
+            int need = j == 0 ? state->numberOfCustomers - 1 - i : 0;
+            currentAllocation[i][j] = allocationRow(state, i)[j] = allocation;
+            remainingNeed[i][j] = needRow(state, i)[j] = need;
+            maximumRow(state, i)[j] = allocation + need;
+        }
+    }
+    memset(state->availableResources, 0, state->numberOfResources * sizeof(int));
+}
+
+// Roda os dois kernels nos dois layouts e imprime os tempos
+static int runKernels(const char *label, int **currentAllocation, int **remainingNeed, BankerState *state, int passes)
+{
+    int numberOfCustomers = state->numberOfCustomers;
+    int numberOfResources = state->numberOfResources;
+    char name[64];
+
+    fillWorstOrder(currentAllocation, remainingNeed, state);
+
+    // Melhor de CHECK_REPEATS execuções alternadas de cada layout (uma execução só varia demais com a máquina ocupada)
+    double pointerTime = 0.0;
+    double contiguousTime = 0.0;
+    int pointerSafe = 0;
+    int contiguousSafe = 0;
+    double start;
+    for (int r = 0; r < CHECK_REPEATS; r++)
+    {
+        start = nowSeconds();
+        pointerSafe = checkSafetyPointerRows(currentAllocation, remainingNeed, state->availableResources, numberOfCustomers, numberOfResources);
+        double elapsed = nowSeconds() - start;
+        pointerTime = r == 0 || elapsed < pointerTime ? elapsed : pointerTime;
+
+        start = nowSeconds();
+        contiguousSafe = checkSafety(state, NULL);
+        elapsed = nowSeconds() - start;
+        contiguousTime = r == 0 || elapsed < contiguousTime ? elapsed : contiguousTime;
+    }
+
+    snprintf(name, sizeof(name), "checkSafety worst order %s", label);
+    printf("%-38s %14.2f %14.2f %8.2fx\n", name, pointerTime * 1e3, contiguousTime * 1e3, pointerTime / contiguousTime);
+
+    // Varredura de linhas inteiras: só a última coluna não cabe em work
+    int work[numberOfResources];
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        work[j] = numberOfCustomers;
+    }
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        remainingNeed[i][numberOfResources - 1] = needRow(state, i)[numberOfResources - 1] = numberOfCustomers + 1;
+    }
+
+    int pointerFits = 0;
+    int contiguousFits = 0;
+    start = nowSeconds();
+    for (int p = 0; p < passes; p++)
+    {
+        pointerFits += scanPointerRows(remainingNeed, work, numberOfCustomers, numberOfResources);
+    }
+    pointerTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    for (int p = 0; p < passes; p++)
+    {
+        contiguousFits += scanContiguous(state, work);
+    }
+    contiguousTime = nowSeconds() - start;
+
+    snprintf(name, sizeof(name), "full-row pass %s", label);
+    printf("%-38s %14.3f %14.3f %8.2fx\n", name, pointerTime / passes * 1e3, contiguousTime / passes * 1e3, pointerTime / contiguousTime);
+
+    return pointerSafe != contiguousSafe || pointerFits != contiguousFits;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfCustomers = argc > 1 ? atoi(argv[1]) : 10000;
+    int numberOfResources = argc > 2 ? atoi(argv[2]) : 64;
+    int passes = argc > 3 ? atoi(argv[3]) : 200;
+    int failures = 0;
+
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    printf("%d customers x %d resources, contiguous row stride %d ints\n", numberOfCustomers, numberOfResources, state->rowStride);
+    printf("%-38s %14s %14s %9s\n", "kernel", "int** ms", "contiguous ms", "speedup");
+
+    // Heap novo: os mallocs de cada linha saem praticamente em sequência
+    int **currentAllocation = allocate2DMatrix(numberOfCustomers, numberOfResources);
+    int **remainingNeed = allocate2DMatrix(numberOfCustomers, numberOfResources);
+    failures += runKernels("(fresh heap)", currentAllocation, remainingNeed, state, passes);
+    free2DMatrix(currentAllocation, numberOfCustomers);
+    free2DMatrix(remainingNeed, numberOfCustomers);
+
+    // Heap fragmentado
+    void **spacers = (void **)malloc(2 * numberOfCustomers * sizeof(void *));
+    srand(7);
+    currentAllocation = allocateFragmented2DMatrix(numberOfCustomers, numberOfResources, spacers);
+    remainingNeed = allocateFragmented2DMatrix(numberOfCustomers, numberOfResources, spacers + numberOfCustomers);
+    failures += runKernels("(fragmented)", currentAllocation, remainingNeed, state, passes);
+    free2DMatrix(currentAllocation, numberOfCustomers);
+    free2DMatrix(remainingNeed, numberOfCustomers);
+    for (int i = 0; i < 2 * numberOfCustomers; i++)
+    {
+        free(spacers[i]);
+    }
+    free(spacers);
+
+    destroyBankerState(state);
+    return failures != 0;
+}
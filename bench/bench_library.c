@@ -0,0 +1,197 @@
+// Benchmark da libbanker (libbanker.h): muitas partições independentes, cada uma um handle Banker
+// Mede criar e destruir os handles (bankerCreate, um bloco por handle, e bankerCreateIn num bloco preparado antes) e
+// comandos/s com as partições divididas entre T threads. As decisões de cada partição têm que ser as de admitRequest e
+// admitRelease sobre um BankerState e um motor próprios, refeitos em série (senão termina com erro)
+// Uso: bench_library [opções da carga, ver bench_generate] [partitions=N] [threads=T]
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "workload.h"
+
+typedef struct
+{
+    const Workload *workload;
+    Banker **partitions;
+    int first;            // Partições [first, last) desta thread
+    int last;
+    unsigned char *decisions; // partitions x count: BankerStatus de cada comando
+} PartitionThread;
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Comando k da partição p: cada partição começa num ponto diferente da lista da carga
+static const Command* partitionCommand(const Workload *workload, int p, long k)
+{
+    return &workload->commands[(k + (long)p * 7919) % workload->count];
+}
+
+// Executa todos os comandos das partições da thread, uma partição de cada vez
+static void* runPartitions(void *argument)
+{
+    PartitionThread *thread = (PartitionThread *)argument;
+    const Workload *workload = thread->workload;
+    for (int p = thread->first; p < thread->last; p++)
+    {
+        unsigned char *decisions = thread->decisions + (size_t)p * workload->count;
+        for (long k = 0; k < workload->count; k++)
+        {
+            const Command *command = partitionCommand(workload, p, k);
+            BankerDecision decision = { BANKER_GRANTED, command->customerID, NULL };
+            if (command->type == COMMAND_REQUEST)
+            {
+                decision = bankerRequest(thread->partitions[p], command->customerID, command->resources);
+            }
+            else if (command->type == COMMAND_RELEASE)
+            {
+                decision = bankerRelease(thread->partitions[p], command->customerID, command->resources);
+            }
+            decisions[k] = (unsigned char)decision.status;
+        }
+    }
+    return NULL;
+}
+
+// Refaz a partição p em série com admitRequest/admitRelease e conta as decisões diferentes
+static long checkPartition(const Workload *workload, int p, const unsigned char *decisions)
+{
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = createSafetyEngine(state);
+    long mismatches = 0;
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = partitionCommand(workload, p, k);
+        int expected = BANKER_GRANTED;
+        if (command->type == COMMAND_REQUEST)
+        {
+            expected = admitRequest(state, engine, command->customerID, command->resources);
+        }
+        else if (command->type == COMMAND_RELEASE)
+        {
+            expected = admitRelease(state, engine, command->customerID, command->resources) ? BANKER_GRANTED : BANKER_EXCEEDS_ALLOCATION;
+        }
+        mismatches += decisions[k] != expected;
+    }
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    options.numberOfCustomers = 32;
+    options.numberOfCommands = 500;
+    int numberOfPartitions = 4000;
+    int numberOfThreads = 4;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "partitions=", 11) == 0)
+        {
+            numberOfPartitions = atoi(argv[i] + 11);
+        }
+        else if (strncmp(argv[i], "threads=", 8) == 0)
+        {
+            numberOfThreads = atoi(argv[i] + 8);
+        }
+        else if (!parseWorkloadOption(&options, argv[i]))
+        {
+            printf("Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Workload *workload = createWorkload(&options);
+    if (!workload || numberOfPartitions <= 0 || numberOfThreads <= 0)
+    {
+        printf("Unable to generate the workload\n");
+        destroyWorkload(workload);
+        return 1;
+    }
+
+    // Demanda máxima sem o padding, como a libbanker recebe
+    const BankerState *initial = workload->initial;
+    int numberOfCustomers = initial->numberOfCustomers;
+    int numberOfResources = initial->numberOfResources;
+    int *maximum = (int *)malloc((size_t)numberOfCustomers * numberOfResources * sizeof(int));
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        memcpy(maximum + (size_t)i * numberOfResources, maximumRow(initial, i), numberOfResources * sizeof(int));
+    }
+    const int *available = initial->availableResources;
+    Banker **partitions = (Banker **)malloc(numberOfPartitions * sizeof(Banker *));
+    size_t handleBytes = bankerMemorySize(numberOfCustomers, numberOfResources);
+
+    // Criação: um bloco por handle, e depois todos os handles num bloco só, preparado antes
+    double start = nowSeconds();
+    for (int p = 0; p < numberOfPartitions; p++)
+    {
+        partitions[p] = bankerCreate(numberOfCustomers, numberOfResources, maximum, available);
+    }
+    double createTime = nowSeconds() - start;
+    start = nowSeconds();
+    for (int p = 0; p < numberOfPartitions; p++)
+    {
+        bankerDestroy(partitions[p]);
+    }
+    double destroyTime = nowSeconds() - start;
+
+    char *slab = (char *)aligned_alloc(64, handleBytes * numberOfPartitions);
+    start = nowSeconds();
+    for (int p = 0; p < numberOfPartitions; p++)
+    {
+        partitions[p] = bankerCreateIn(slab + (size_t)p * handleBytes, handleBytes, numberOfCustomers, numberOfResources, maximum, available);
+    }
+    double createInTime = nowSeconds() - start;
+
+    // Comandos: cada thread fica com um intervalo de partições
+    unsigned char *decisions = (unsigned char *)malloc((size_t)numberOfPartitions * workload->count);
+    PartitionThread threads[numberOfThreads];
+    pthread_t ids[numberOfThreads];
+    start = nowSeconds();
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+        threads[t].workload = workload;
+        threads[t].partitions = partitions;
+        threads[t].first = (int)((long)numberOfPartitions * t / numberOfThreads);
+        threads[t].last = (int)((long)numberOfPartitions * (t + 1) / numberOfThreads);
+        threads[t].decisions = decisions;
+        pthread_create(&ids[t], NULL, runPartitions, &threads[t]);
+    }
+    for (int t = 0; t < numberOfThreads; t++)
+    {
+        pthread_join(ids[t], NULL);
+    }
+    double runTime = nowSeconds() - start;
+
+    long mismatches = 0;
+    for (int p = 0; p < numberOfPartitions; p++)
+    {
+        mismatches += checkPartition(workload, p, decisions + (size_t)p * workload->count);
+        bankerDestroy(partitions[p]);
+    }
+
+    long commands = (long)numberOfPartitions * workload->count;
+    printf("%d partitions x %d customers, %d resources, %ld commands each, %d threads\n", numberOfPartitions,
+           numberOfCustomers, numberOfResources, workload->count, numberOfThreads);
+    printf("%-28s %10zu\n", "bytes per handle", handleBytes);
+    printf("%-28s %10.0f ns\n", "bankerCreate", createTime / numberOfPartitions * 1e9);
+    printf("%-28s %10.0f ns\n", "bankerDestroy", destroyTime / numberOfPartitions * 1e9);
+    printf("%-28s %10.0f ns\n", "bankerCreateIn (slab)", createInTime / numberOfPartitions * 1e9);
+    printf("%-28s %10.0f\n", "commands/s", commands / runTime);
+    printf("mismatches %ld\n", mismatches);
+
+    free(slab);
+    free(decisions);
+    free(partitions);
+    free(maximum);
+    destroyWorkload(workload);
+    return mismatches != 0;
+}
@@ -0,0 +1,96 @@
+// Benchmark de escala da checagem de segurança paralela (1 a N threads)
+// Uso: bench_parallel [customers] [resources] [maxThreads] [checks]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "banker.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfCustomers = argc > 1 ? atoi(argv[1]) : 200000;
+    int numberOfResources = argc > 2 ? atoi(argv[2]) : 16;
+    int maxThreads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int checks = argc > 4 ? atoi(argv[4]) : 5;
+    int mismatches = 0;
+
+    srand(42);
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            maximumRow(state, i)[j] = rand() % 100;
+            allocationRow(state, i)[j] = rand() % (maximumRow(state, i)[j] + 1) / 4;
+            needRow(state, i)[j] = maximumRow(state, i)[j] - allocationRow(state, i)[j];
+        }
+    }
+
+    // Recursos disponíveis apertados: o estado é seguro mas precisa de várias passadas
+    SafetyEngine *engine = createSafetyEngine(state);
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        state->availableResources[j] = 10;
+    }
+    while (!safetyEngineCheck(engine, state, -1))
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            state->availableResources[j] += 5;
+        }
+    }
+
+    double start = nowSeconds();
+    int expected = safetyEngineCheck(engine, state, -1);
+    double engineTime = nowSeconds() - start;
+    destroySafetyEngine(engine);
+
+    printf("%d customers x %d resources, kernels %s\n", numberOfCustomers, numberOfResources, getSafetyKernels()->name);
+    printf("incremental engine (serial): %.2f ms\n", engineTime * 1e3);
+    printf("%7s %12s %9s\n", "threads", "ms/check", "speedup");
+
+    double singleThreadTime = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        ThreadPool *pool = createThreadPool(threads);
+        start = nowSeconds();
+        for (int c = 0; c < checks; c++)
+        {
+            mismatches += checkSafetyParallel(pool, state) != expected;
+        }
+        double elapsed = (nowSeconds() - start) / checks;
+        destroyThreadPool(pool);
+
+        if (threads == 1)
+        {
+            singleThreadTime = elapsed;
+        }
+        printf("%7d %12.2f %8.2fx\n", threads, elapsed * 1e3, singleThreadTime / elapsed);
+
+        // Garante que o último ponto é exatamente maxThreads
+        if (threads < maxThreads && threads * 2 > maxThreads)
+        {
+            threads = maxThreads / 2;
+        }
+    }
+
+    // Estado inseguro: o veredito também tem que bater
+    state->availableResources[0] = 0;
+    engine = createSafetyEngine(state);
+    expected = safetyEngineCheck(engine, state, -1);
+    destroySafetyEngine(engine);
+    ThreadPool *pool = createThreadPool(maxThreads);
+    mismatches += checkSafetyParallel(pool, state) != expected;
+    destroyThreadPool(pool);
+
+    printf("mismatches: %d\n", mismatches);
+    destroyBankerState(state);
+    return mismatches != 0;
+}
@@ -0,0 +1,197 @@
+// Benchmark de leitura de commands.txt: getline + sscanf + strtok + atoi contra o parser sobre mmap e o trace binário
+// Uso: bench_parser [lines] [customers] [resources] [file]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include "banker.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Caminho antigo de processBankerCommands, só a parte de leitura (soma os valores lidos)
+static long long parseWithGetline(const char *filename, int numberOfResources, long long *commands)
+{
+    FILE *file = fopen(filename, "r");
+    char *line = NULL;
+    size_t len = 0;
+    long long checksum = 0;
+
+    while (getline(&line, &len, file) != -1)
+    {
+        char command[3];
+        int customerID;
+        int resources[numberOfResources];
+
+        if (strcmp(line, "*\n") == 0 || strcmp(line, "*") == 0)
+        {
+            checksum += 7;
+            (*commands)++;
+            continue;
+        }
+        if (sscanf(line, "%2s %d", command, &customerID) < 2)
+        {
+            break;
+        }
+
+        char *token = strtok(line, " ");
+        token = strtok(NULL, " ");
+        token = strtok(NULL, " ");
+        for (int i = 0; i < numberOfResources && token != NULL; i++)
+        {
+            resources[i] = atoi(token);
+            token = strtok(NULL, " ");
+        }
+
+        checksum += customerID + (command[1] == 'Q');
+        for (int i = 0; i < numberOfResources; i++)
+        {
+            checksum += resources[i];
+        }
+        (*commands)++;
+
+        free(line);
+        line = NULL;
+    }
+
+    free(line);
+    fclose(file);
+    return checksum;
+}
+
+static long long parseWithMmap(const char *filename, int numberOfCustomers, int numberOfResources, long long *commands)
+{
+    MappedFile file;
+    CommandParser parser;
+    Command command;
+    int resources[numberOfResources];
+    long long checksum = 0;
+
+    mapFile(filename, &file);
+    initCommandParser(&parser, file.data, file.size, numberOfCustomers, numberOfResources, resources);
+    while (nextCommand(&parser, &command) > 0)
+    {
+        if (command.type == COMMAND_PRINT)
+        {
+            checksum += 7;
+        }
+        else
+        {
+            checksum += command.customerID + (command.type == COMMAND_REQUEST);
+            for (int i = 0; i < numberOfResources; i++)
+            {
+                checksum += command.resources[i];
+            }
+        }
+        (*commands)++;
+    }
+    unmapFile(&file);
+    return checksum;
+}
+
+static long long parseBinaryTrace(const char *filename, int numberOfResources, long long *commands)
+{
+    BinaryTrace trace;
+    Command command;
+    long long checksum = 0;
+
+    openBinaryTrace(filename, &trace);
+    while (nextTraceRecord(&trace, &command) > 0)
+    {
+        if (command.type == COMMAND_PRINT)
+        {
+            checksum += 7;
+        }
+        else
+        {
+            checksum += command.customerID + (command.type == COMMAND_REQUEST);
+            for (int i = 0; i < numberOfResources; i++)
+            {
+                checksum += command.resources[i];
+            }
+        }
+        (*commands)++;
+    }
+    closeBinaryTrace(&trace);
+    return checksum;
+}
+
+int main(int argc, char *argv[])
+{
+    long lines = argc > 1 ? atol(argv[1]) : 2000000;
+    int numberOfCustomers = argc > 2 ? atoi(argv[2]) : 1000;
+    int numberOfResources = argc > 3 ? atoi(argv[3]) : 8;
+    const char *filename = argc > 4 ? argv[4] : "/tmp/bench_parser_commands.txt";
+
+    // Gera o arquivo de comandos
+    FILE *file = fopen(filename, "w");
+    if (!file)
+    {
+        printf("Unable to create %s\n", filename);
+        return 1;
+    }
+    srand(42);
+    for (long l = 0; l < lines; l++)
+    {
+        if (rand() % 100 == 0)
+        {
+            fprintf(file, "*\n");
+            continue;
+        }
+        fprintf(file, "%s %d", rand() % 3 ? "RQ" : "RL", rand() % numberOfCustomers);
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            fprintf(file, " %d", rand() % 20);
+        }
+        fprintf(file, "\n");
+    }
+    long bytes = ftell(file);
+    fclose(file);
+
+    // Lê uma vez antes para os dois caminhos pegarem o arquivo no page cache
+    long long oldCommands = 0;
+    long long newCommands = 0;
+    long long binaryCommands = 0;
+    parseWithMmap(filename, numberOfCustomers, numberOfResources, &newCommands);
+    newCommands = 0;
+
+    // Converte para o trace binário
+    char binaryFilename[4096];
+    snprintf(binaryFilename, sizeof(binaryFilename), "%s.bin", filename);
+    if (convertTextTrace(filename, binaryFilename) < 0)
+    {
+        remove(filename);
+        return 1;
+    }
+    parseBinaryTrace(binaryFilename, numberOfResources, &binaryCommands);
+    binaryCommands = 0;
+
+    double start = nowSeconds();
+    long long oldChecksum = parseWithGetline(filename, numberOfResources, &oldCommands);
+    double oldTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    long long newChecksum = parseWithMmap(filename, numberOfCustomers, numberOfResources, &newCommands);
+    double newTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    long long binaryChecksum = parseBinaryTrace(binaryFilename, numberOfResources, &binaryCommands);
+    double binaryTime = nowSeconds() - start;
+
+    double megabytes = bytes / 1e6;
+    printf("%ld lines, %.1f MB, %d resources\n", lines, megabytes, numberOfResources);
+    printf("%-26s %10s %12s\n", "parser", "MB/s", "Mcommands/s");
+    printf("%-26s %10.1f %12.2f\n", "getline+sscanf+strtok", megabytes / oldTime, oldCommands / oldTime / 1e6);
+    printf("%-26s %10.1f %12.2f\n", "mmap single pass", megabytes / newTime, newCommands / newTime / 1e6);
+    printf("%-26s %10.1f %12.2f\n", "binary trace replay", megabytes / binaryTime, binaryCommands / binaryTime / 1e6);
+    printf("speedup %.2fx (mmap), %.2fx (binary trace)\n", oldTime / newTime, oldTime / binaryTime);
+
+    remove(filename);
+    remove(binaryFilename);
+    return oldChecksum != newChecksum || oldCommands != newCommands || binaryChecksum != newChecksum || binaryCommands != newCommands;
+}
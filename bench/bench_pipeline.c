@@ -0,0 +1,171 @@
+// Benchmark de ponta a ponta de commands.txt (e do trace binário) até result.txt: o laço serial de processBankerCommands
+// (ler, decidir e formatar na mesma thread) contra runCommandPipeline (três threads ligadas por filas SPSC)
+// Mostra comandos/s de cada modo e termina com erro se os dois result.txt não forem idênticos byte a byte
+// Uso: bench_pipeline [opções da carga, ver bench_generate] [dir=PATH]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "workload.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Um comando no modo serial, como executeCommand sem lote
+static void executeSerial(BankerState *state, SafetyEngine *engine, OutputWriter *writer, const Command *command)
+{
+    if (command->type == COMMAND_PRINT)
+    {
+        writeStateSnapshot(writer, state);
+    }
+    else if (command->type == COMMAND_REQUEST)
+    {
+        RequestDecision decision = admitRequest(state, engine, command->customerID, command->resources);
+        writeRequestDecision(writer, decision, command->customerID, command->resources, state->availableResources, state->numberOfResources);
+    }
+    else if (command->type == COMMAND_RELEASE)
+    {
+        int released = admitRelease(state, engine, command->customerID, command->resources);
+        writeReleaseDecision(writer, released, command->customerID, command->resources, state->numberOfResources);
+    }
+}
+
+// Executa o arquivo de comandos (texto ou trace) num estado novo e escreve output. Retorna os segundos, ou -1 se falhou
+static double runMode(const Workload *workload, const char *commands, int binaryTrace, int pipeline, const char *output)
+{
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = createSafetyEngine(state);
+    OutputWriter *writer = openOutputWriter(output);
+    int numberOfResources = state->numberOfResources;
+    int resources[numberOfResources + 1];
+    int ok = 1;
+
+    double start = nowSeconds();
+    if (pipeline)
+    {
+        ok = runCommandPipeline(commands, binaryTrace, state, engine, writer);
+    }
+    else if (binaryTrace)
+    {
+        BinaryTrace trace;
+        Command command;
+        ok = openBinaryTrace(commands, &trace);
+        while (ok && nextTraceRecord(&trace, &command) > 0)
+        {
+            executeSerial(state, engine, writer, &command);
+        }
+        if (ok)
+        {
+            closeBinaryTrace(&trace);
+        }
+    }
+    else
+    {
+        MappedFile file;
+        CommandParser parser;
+        Command command;
+        ok = mapFile(commands, &file);
+        initCommandParser(&parser, file.data, file.size, state->numberOfCustomers, numberOfResources, resources);
+        while (ok && nextCommand(&parser, &command) > 0)
+        {
+            executeSerial(state, engine, writer, &command);
+        }
+        unmapFile(&file);
+    }
+    ok = closeOutputWriter(writer) && ok; // result.txt só está completo depois do último write
+    double elapsed = nowSeconds() - start;
+
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    return ok ? elapsed : -1.0;
+}
+
+// 1 se os dois arquivos têm o mesmo conteúdo
+static int sameFile(const char *first, const char *second)
+{
+    MappedFile a;
+    MappedFile b;
+    if (!mapFile(first, &a))
+    {
+        return 0;
+    }
+    if (!mapFile(second, &b))
+    {
+        unmapFile(&a);
+        return 0;
+    }
+    int same = a.size == b.size && (a.size == 0 || memcmp(a.data, b.data, a.size) == 0);
+    unmapFile(&a);
+    unmapFile(&b);
+    return same;
+}
+
+int main(int argc, char *argv[])
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    options.numberOfCommands = 500000;
+    options.printShare = 0.001;
+    const char *directory = "/tmp/bench_pipeline";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "dir=", 4) == 0)
+        {
+            directory = argv[i] + 4;
+        }
+        else if (!parseWorkloadOption(&options, argv[i]))
+        {
+            printf("Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Workload *workload = createWorkload(&options);
+    mkdir(directory, 0755);
+    if (!workload || !writeWorkloadFiles(workload, directory))
+    {
+        printf("Unable to write the workload to %s\n", directory);
+        destroyWorkload(workload);
+        return 1;
+    }
+
+    char commands[4096];
+    char trace[4096];
+    char serialOutput[4096];
+    char pipelineOutput[4096];
+    snprintf(commands, sizeof(commands), "%s/commands.txt", directory);
+    snprintf(trace, sizeof(trace), "%s/commands.bin", directory);
+    snprintf(serialOutput, sizeof(serialOutput), "%s/result_serial.txt", directory);
+    snprintf(pipelineOutput, sizeof(pipelineOutput), "%s/result_pipeline.txt", directory);
+    if (convertTextTrace(commands, trace) < 0)
+    {
+        destroyWorkload(workload);
+        return 1;
+    }
+
+    printf("%d customers, %d resources, %ld commands\n", options.numberOfCustomers, options.numberOfResources, workload->count);
+    printf("%-14s %12s %12s %12s %12s %9s %10s\n", "input", "serial ms", "pipeline ms", "serial c/s", "pipeline c/s",
+           "speedup", "identical");
+    int failed = 0;
+    for (int binaryTrace = 0; binaryTrace <= 1; binaryTrace++)
+    {
+        const char *input = binaryTrace ? trace : commands;
+        double serialTime = runMode(workload, input, binaryTrace, 0, serialOutput);
+        double pipelineTime = runMode(workload, input, binaryTrace, 1, pipelineOutput);
+        int identical = serialTime >= 0 && pipelineTime >= 0 && sameFile(serialOutput, pipelineOutput);
+        printf("%-14s %12.1f %12.1f %12.0f %12.0f %8.2fx %10s\n", binaryTrace ? "binary trace" : "commands.txt",
+               serialTime * 1e3, pipelineTime * 1e3, workload->count / serialTime, workload->count / pipelineTime,
+               serialTime / pipelineTime, identical ? "yes" : "NO");
+        failed |= !identical;
+    }
+
+    remove(serialOutput);
+    remove(pipelineOutput);
+    destroyWorkload(workload);
+    return failed;
+}
@@ -0,0 +1,162 @@
+// Benchmark do QM (query.c): o maior pedido aceito de cada cliente, pela busca binária com o motor incremental contra
+// subir um pedido de uma unidade por vez até checkSafety recusar (a resposta óbvia, uma checagem completa por unidade)
+// O estado é o fim de uma carga gerada; mostra o tempo por modo e termina com erro se algum vetor for diferente
+// Uso: bench_query [opções da carga, ver bench_generate]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "workload.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 1 se o pedido request de customerID passa dos limites dos RQ ou deixa o estado inseguro (checkSafety completo)
+static int refused(const BankerState *state, int customerID, const int *request)
+{
+    int rowLength = state->rowStride;
+    int available[rowLength];
+    int allocation[rowLength];
+    int need[rowLength];
+    memcpy(available, state->availableResources, rowLength * sizeof(int));
+    memcpy(allocation, allocationRow(state, customerID), rowLength * sizeof(int));
+    memcpy(need, needRow(state, customerID), rowLength * sizeof(int));
+    for (int j = 0; j < state->numberOfResources; j++)
+    {
+        if (request[j] > need[j] || request[j] > available[j])
+        {
+            return 1;
+        }
+        available[j] -= request[j];
+        allocation[j] += request[j];
+        need[j] -= request[j];
+    }
+    SafetyOverlay overlay = { customerID, available, allocation, need };
+    return !checkSafetyOverlay(state, &overlay, NULL);
+}
+
+// Uma unidade por vez ao longo de direction (NULL: cada recurso sozinho), como maxGrantableAll
+static void probeAll(const BankerState *state, const int *direction, int *grantable)
+{
+    int numberOfResources = state->numberOfResources;
+    int request[numberOfResources + 1];
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        int *row = grantable + (size_t)i * numberOfResources;
+        for (int j = 0; j < (direction ? 1 : numberOfResources); j++)
+        {
+            int t = 0;
+            for (;;)
+            {
+                for (int k = 0; k < numberOfResources; k++)
+                {
+                    request[k] = direction ? (t + 1) * direction[k] : (k == j) * (t + 1);
+                }
+                if (refused(state, i, request))
+                {
+                    break;
+                }
+                t++;
+            }
+            for (int k = 0; direction && k < numberOfResources; k++)
+            {
+                row[k] = t * direction[k];
+            }
+            if (!direction)
+            {
+                row[j] = t;
+            }
+        }
+    }
+}
+
+// Aplica os RQ e RL da carga ao estado inicial: o QM é medido no estado do fim, com alocações espalhadas
+static BankerState* replayWorkload(const Workload *workload)
+{
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = createSafetyEngine(state);
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = &workload->commands[k];
+        if (command->type == COMMAND_REQUEST)
+        {
+            admitRequest(state, engine, command->customerID, command->resources);
+        }
+        else if (command->type == COMMAND_RELEASE)
+        {
+            admitRelease(state, engine, command->customerID, command->resources);
+        }
+    }
+    destroySafetyEngine(engine);
+    return state;
+}
+
+int main(int argc, char *argv[])
+{
+    WorkloadOptions options;
+    defaultWorkloadOptions(&options);
+    options.numberOfCustomers = 500;
+    options.numberOfCommands = 50000;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!parseWorkloadOption(&options, argv[i]))
+        {
+            printf("Invalid option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    Workload *workload = createWorkload(&options);
+    if (!workload)
+    {
+        printf("Unable to generate the workload\n");
+        return 1;
+    }
+    BankerState *state = replayWorkload(workload);
+    SafetyEngine *engine = createSafetyEngine(state);
+    int numberOfResources = state->numberOfResources;
+    size_t length = (size_t)state->numberOfCustomers * numberOfResources;
+    int *expected = (int *)calloc(length, sizeof(int));
+    int *grantable = (int *)calloc(length, sizeof(int));
+    int ones[numberOfResources + 1];
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        ones[j] = 1;
+    }
+
+    printf("%d customers, %d resources, %ld commands\n", options.numberOfCustomers, numberOfResources, workload->count);
+    printf("%-14s %12s %12s %9s %11s\n", "query", "probe ms", "search ms", "speedup", "mismatches");
+    long failed = 0;
+    for (int mode = 0; mode <= 1; mode++)
+    {
+        const int *direction = mode ? ones : NULL;
+        double start = nowSeconds();
+        probeAll(state, direction, expected);
+        double probeTime = nowSeconds() - start;
+
+        start = nowSeconds();
+        maxGrantableAll(state, engine, direction, grantable);
+        double searchTime = nowSeconds() - start;
+
+        long mismatches = 0;
+        for (int i = 0; i < state->numberOfCustomers; i++)
+        {
+            mismatches += memcmp(expected + (size_t)i * numberOfResources, grantable + (size_t)i * numberOfResources,
+                                 numberOfResources * sizeof(int)) != 0;
+        }
+        printf("%-14s %12.1f %12.1f %8.1fx %11ld\n", mode ? "along 1 1 ..." : "per resource", probeTime * 1e3,
+               searchTime * 1e3, probeTime / searchTime, mismatches);
+        failed += mismatches;
+    }
+
+    free(expected);
+    free(grantable);
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    destroyWorkload(workload);
+    return failed != 0;
+}
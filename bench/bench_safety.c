@@ -0,0 +1,138 @@
+// Benchmark: checkSafety (O(n²·m)) contra o motor incremental de segurança (O(n·m))
+// Uso: bench_safety [maxCustomers] [resources] [checksPerSize] [seed]
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "banker.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int minimum(int a, int b)
+{
+    return a < b ? a : b;
+}
+
+// Executa uma rodada de pedidos e liberações aleatórias para um número de clientes, comparando os dois métodos
+static int runSize(int numberOfCustomers, int numberOfResources, int checks, unsigned seed)
+{
+    srand(seed);
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    int *available = state->availableResources;
+    int request[numberOfResources];
+
+    // Estado inicial: alocação aleatória abaixo da demanda máxima
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        int *maximum = maximumRow(state, i);
+        int *allocation = allocationRow(state, i);
+        int *need = needRow(state, i);
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            maximum[j] = rand() % 10;
+            allocation[j] = rand() % (maximum[j] + 1) / 2;
+            need[j] = maximum[j] - allocation[j];
+        }
+    }
+
+    // Recursos disponíveis: o menor valor (a partir de 4) que deixa o estado inicial seguro
+    SafetyEngine *engine = createSafetyEngine(state);
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        available[j] = 4;
+    }
+    while (!safetyEngineCheck(engine, state, -1))
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            available[j]++;
+        }
+    }
+
+    double fullTime = 0;
+    double incrementalTime = 0;
+    int granted = 0;
+    int mismatches = 0;
+
+    for (int c = 0; c < checks; c++)
+    {
+        int customer = rand() % numberOfCustomers;
+        int *allocation = allocationRow(state, customer);
+        int *need = needRow(state, customer);
+
+        // Uma em cada quatro operações é uma liberação, para o estado não travar
+        if (rand() % 4 == 0)
+        {
+            for (int j = 0; j < numberOfResources; j++)
+            {
+                int amount = rand() % (allocation[j] + 1);
+                available[j] += amount;
+                allocation[j] -= amount;
+                need[j] += amount;
+            }
+            safetyEngineUpdateCustomer(engine, state, customer);
+            c--;
+            continue;
+        }
+
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            request[j] = rand() % (minimum(minimum(need[j], available[j]), 3) + 1);
+            available[j] -= request[j];
+            allocation[j] += request[j];
+            need[j] -= request[j];
+        }
+
+        double start = nowSeconds();
+        int fullSafe = checkSafety(state, NULL);
+        double middle = nowSeconds();
+        int incrementalSafe = safetyEngineCheck(engine, state, customer);
+        double end = nowSeconds();
+
+        fullTime += middle - start;
+        incrementalTime += end - middle;
+        mismatches += fullSafe != incrementalSafe;
+
+        if (fullSafe)
+        {
+            safetyEngineUpdateCustomer(engine, state, customer);
+            granted++;
+        }
+        else
+        {
+            for (int j = 0; j < numberOfResources; j++)
+            {
+                available[j] += request[j];
+                allocation[j] -= request[j];
+                need[j] += request[j];
+            }
+        }
+    }
+
+    printf("%9d %9d %8d %14.2f %14.2f %9.1fx %10d\n", numberOfCustomers, numberOfResources, granted,
+           fullTime / checks * 1e6, incrementalTime / checks * 1e6, fullTime / incrementalTime, mismatches);
+
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    int maxCustomers = argc > 1 ? atoi(argv[1]) : 4000;
+    int numberOfResources = argc > 2 ? atoi(argv[2]) : 8;
+    int checks = argc > 3 ? atoi(argv[3]) : 100;
+    unsigned seed = argc > 4 ? (unsigned)atoi(argv[4]) : 42;
+    int mismatches = 0;
+
+    printf("%9s %9s %8s %14s %14s %10s %10s\n", "customers", "resources", "granted", "full us/chk", "incr us/chk", "speedup", "mismatch");
+    for (int n = 250; n <= maxCustomers; n *= 2)
+    {
+        mismatches += runSize(n, numberOfResources, checks, seed);
+    }
+    return mismatches != 0;
+}
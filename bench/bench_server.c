@@ -0,0 +1,319 @@
+// Gerador de carga do servidor (--serve): N clientes em laço fechado mandam RQ/RL/* e medem a latência de cada decisão
+// Sem socketPath, sobe um servidor no mesmo processo (numa thread) com um estado aleatório; com socketPath, usa o daemon
+// já rodando (customers é ignorado, os números vêm do cabeçalho do servidor)
+// Termina com erro se alguma resposta violar o protocolo
+// Uso: bench_server [clients] [requestsPerClient] [customers] [resources] [socketPath]
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "banker.h"
+
+typedef struct
+{
+    const char *socketPath;
+    int index;               // Este cliente usa os clientes do banqueiro index, index + clients, ...
+    int clients;
+    int requests;
+    double *latencies;       // Latência de cada comando (segundos)
+    long granted;
+    long denied;
+    long errors;             // Respostas fora do protocolo
+} LoadClient;
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int readAll(int socket, void *data, size_t length)
+{
+    char *bytes = (char *)data;
+    while (length > 0)
+    {
+        ssize_t received = read(socket, bytes, length);
+        if (received <= 0)
+        {
+            return 0;
+        }
+        bytes += received;
+        length -= received;
+    }
+    return 1;
+}
+
+static int writeAll(int socket, const void *data, size_t length)
+{
+    const char *bytes = (const char *)data;
+    while (length > 0)
+    {
+        ssize_t sent = write(socket, bytes, length);
+        if (sent <= 0)
+        {
+            return 0;
+        }
+        bytes += sent;
+        length -= sent;
+    }
+    return 1;
+}
+
+static int connectServer(const char *socketPath)
+{
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+// Lê o cabeçalho do servidor. Retorna 0 se não for um servidor do banqueiro
+static int readHello(int fd, uint32_t *customers, uint32_t *resources)
+{
+    char hello[16];
+    uint16_t version;
+    if (!readAll(fd, hello, sizeof(hello)) || memcmp(hello, "BNKS", 4) != 0)
+    {
+        return 0;
+    }
+    memcpy(&version, hello + 4, 2);
+    memcpy(customers, hello + 8, 4);
+    memcpy(resources, hello + 12, 4);
+    return version == SERVER_PROTOCOL_VERSION && *customers > 0 && *resources > 0;
+}
+
+static void* runLoadClient(void *argument)
+{
+    LoadClient *load = (LoadClient *)argument;
+    int fd = connectServer(load->socketPath);
+    uint32_t customers;
+    uint32_t resources;
+    if (fd < 0 || !readHello(fd, &customers, &resources))
+    {
+        load->errors++;
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return NULL;
+    }
+
+    // Alocação de cada cliente do banqueiro deste gerador (só ele mexe neles, então a cópia local é exata)
+    int owned = ((int)customers - load->index + load->clients - 1) / load->clients;
+    if (owned <= 0)
+    {
+        load->errors++;
+        close(fd);
+        return NULL;
+    }
+    int *held = (int *)calloc((size_t)owned * resources, sizeof(int));
+    char *message = (char *)malloc(4 + 4 * (size_t)resources);
+    char *snapshot = NULL;
+    size_t snapshotCapacity = 0;
+    unsigned seed = 1234567u * (load->index + 1);
+
+    for (int r = 0; r < load->requests; r++)
+    {
+        int slot = rand_r(&seed) % owned;
+        uint32_t customerID = load->index + slot * load->clients;
+        int *allocation = held + (size_t)slot * resources;
+        int dice = rand_r(&seed) % 100;
+        uint32_t opcode = dice < 70 ? COMMAND_OPCODE_REQUEST : dice < 99 ? COMMAND_OPCODE_RELEASE : COMMAND_OPCODE_SNAPSHOT;
+        uint32_t word = customerID << 2 | opcode;
+        int *values = (int *)(message + 4);
+        memcpy(message, &word, 4);
+        for (uint32_t j = 0; j < resources && opcode != COMMAND_OPCODE_SNAPSHOT; j++)
+        {
+            int value = opcode == COMMAND_OPCODE_REQUEST ? rand_r(&seed) % 3 : allocation[j];
+            memcpy(&values[j], &value, 4);
+        }
+
+        size_t length = opcode == COMMAND_OPCODE_SNAPSHOT ? 4 : 4 + 4 * (size_t)resources;
+        unsigned char status;
+        double start = nowSeconds();
+        if (!writeAll(fd, message, length) || !readAll(fd, &status, 1))
+        {
+            load->errors++;
+            break;
+        }
+        if (opcode == COMMAND_OPCODE_SNAPSHOT)
+        {
+            uint32_t textLength;
+            if (status != SERVER_STATUS_OK || !readAll(fd, &textLength, 4))
+            {
+                load->errors++;
+                break;
+            }
+            if (textLength > snapshotCapacity)
+            {
+                snapshotCapacity = textLength;
+                snapshot = (char *)realloc(snapshot, snapshotCapacity);
+            }
+            if (!readAll(fd, snapshot, textLength))
+            {
+                load->errors++;
+                break;
+            }
+        }
+        load->latencies[r] = nowSeconds() - start;
+
+        if (opcode == COMMAND_OPCODE_REQUEST)
+        {
+            if (status > REQUEST_UNSAFE)
+            {
+                load->errors++;
+            }
+            else if (status == REQUEST_GRANTED)
+            {
+                load->granted++;
+                for (uint32_t j = 0; j < resources; j++)
+                {
+                    int value;
+                    memcpy(&value, &values[j], 4);
+                    allocation[j] += value;
+                }
+            }
+            else
+            {
+                load->denied++;
+            }
+        }
+        else if (opcode == COMMAND_OPCODE_RELEASE)
+        {
+            // Devolve exatamente o que tem: o servidor não pode negar
+            if (status != SERVER_STATUS_OK)
+            {
+                load->errors++;
+            }
+            memset(allocation, 0, resources * sizeof(int));
+        }
+    }
+
+    free(held);
+    free(message);
+    free(snapshot);
+    close(fd);
+    return NULL;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void* runServerThread(void *argument)
+{
+    runBankerServer((BankerServer *)argument);
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    int clients = argc > 1 ? atoi(argv[1]) : 8;
+    int requestsPerClient = argc > 2 ? atoi(argv[2]) : 20000;
+    int numberOfCustomers = argc > 3 ? atoi(argv[3]) : 1000;
+    int numberOfResources = argc > 4 ? atoi(argv[4]) : 8;
+    const char *socketPath = argc > 5 ? argv[5] : NULL;
+    char localPath[64];
+
+    BankerState *state = NULL;
+    SafetyEngine *engine = NULL;
+    BankerServer *server = NULL;
+    pthread_t serverThread;
+    if (!socketPath)
+    {
+        state = createBankerState(numberOfCustomers, numberOfResources);
+        srand(42);
+        for (int i = 0; i < numberOfCustomers; i++)
+        {
+            for (int j = 0; j < numberOfResources; j++)
+            {
+                maximumRow(state, i)[j] = rand() % 20;
+                needRow(state, i)[j] = maximumRow(state, i)[j];
+            }
+        }
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            state->availableResources[j] = 2 * numberOfCustomers;
+        }
+        engine = createSafetyEngine(state);
+
+        snprintf(localPath, sizeof(localPath), "/tmp/bench_server_%d.sock", (int)getpid());
+        socketPath = localPath;
+        server = createBankerServer(socketPath, state, engine);
+        if (!server)
+        {
+            printf("Unable to listen on %s\n", socketPath);
+            return 1;
+        }
+        pthread_create(&serverThread, NULL, runServerThread, server);
+    }
+
+    LoadClient *loads = (LoadClient *)calloc(clients, sizeof(LoadClient));
+    pthread_t *threads = (pthread_t *)malloc(clients * sizeof(pthread_t));
+    double *latencies = (double *)calloc((size_t)clients * requestsPerClient, sizeof(double));
+
+    double start = nowSeconds();
+    for (int c = 0; c < clients; c++)
+    {
+        loads[c].socketPath = socketPath;
+        loads[c].index = c;
+        loads[c].clients = clients;
+        loads[c].requests = requestsPerClient;
+        loads[c].latencies = latencies + (size_t)c * requestsPerClient;
+        pthread_create(&threads[c], NULL, runLoadClient, &loads[c]);
+    }
+    long granted = 0;
+    long denied = 0;
+    long errors = 0;
+    for (int c = 0; c < clients; c++)
+    {
+        pthread_join(threads[c], NULL);
+        granted += loads[c].granted;
+        denied += loads[c].denied;
+        errors += loads[c].errors;
+    }
+    double elapsed = nowSeconds() - start;
+
+    if (server)
+    {
+        stopBankerServer(server);
+        pthread_join(serverThread, NULL);
+        destroyBankerServer(server);
+        destroySafetyEngine(engine);
+        destroyBankerState(state);
+    }
+
+    long total = (long)clients * requestsPerClient;
+    qsort(latencies, total, sizeof(double), compareDoubles);
+    printf("%d clients x %d commands on %s\n", clients, requestsPerClient, socketPath);
+    printf("%.0f commands/s, RQ granted %ld denied %ld\n", total / elapsed, granted, denied);
+    printf("%8s %8s %8s %8s\n", "p50 us", "p99 us", "p999 us", "max us");
+    printf("%8.1f %8.1f %8.1f %8.1f\n", latencies[total / 2] * 1e6, latencies[total * 99 / 100] * 1e6,
+           latencies[total * 999 / 1000] * 1e6, latencies[total - 1] * 1e6);
+    printf("protocol errors: %ld\n", errors);
+
+    free(loads);
+    free(threads);
+    free(latencies);
+    return errors != 0;
+}
@@ -0,0 +1,145 @@
+// Benchmark dos kernels SIMD de checkSafety, com checagem de que todos dão o mesmo resultado que o escalar
+// Uso: bench_simd [customers] [resources] [randomStates] [seed]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "banker.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Estado aleatório: alocação abaixo da demanda máxima e recursos disponíveis perto do limite de segurança
+static BankerState* randomState(int numberOfCustomers, int numberOfResources)
+{
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            maximumRow(state, i)[j] = rand() % 10;
+            allocationRow(state, i)[j] = rand() % (maximumRow(state, i)[j] + 1);
+            needRow(state, i)[j] = maximumRow(state, i)[j] - allocationRow(state, i)[j];
+        }
+    }
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        state->availableResources[j] = rand() % 12;
+    }
+    return state;
+}
+
+// Compara os kernels diretamente, com tamanhos que não são múltiplos do vetor
+static int compareKernelsDirectly(const SafetyKernels *kernels, int rounds)
+{
+    int mismatches = 0;
+    for (int r = 0; r < rounds; r++)
+    {
+        int length = 1 + rand() % 70;
+        int need[length], work[length], allocation[length], expected[length];
+        for (int j = 0; j < length; j++)
+        {
+            need[j] = rand() % 8;
+            work[j] = rand() % 8 + 3;
+            allocation[j] = rand() % 5;
+        }
+        mismatches += kernels->needFitsWork(need, work, length) != scalarKernels.needFitsWork(need, work, length);
+
+        memcpy(expected, work, sizeof(work));
+        scalarKernels.addToWork(expected, allocation, length);
+        kernels->addToWork(work, allocation, length);
+        mismatches += memcmp(expected, work, sizeof(work)) != 0;
+    }
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfCustomers = argc > 1 ? atoi(argv[1]) : 2000;
+    int numberOfResources = argc > 2 ? atoi(argv[2]) : 64;
+    int randomStates = argc > 3 ? atoi(argv[3]) : 500;
+    srand(argc > 4 ? (unsigned)atoi(argv[4]) : 42);
+
+    const char *names[] = { "scalar", "sse2", "avx2" };
+    const SafetyKernels *available[3];
+    int count = 0;
+    int mismatches = 0;
+
+    for (int k = 0; k < 3; k++)
+    {
+        if ((available[count] = findSafetyKernels(names[k])))
+        {
+            count++;
+        }
+        else
+        {
+            printf("%s: not supported by this CPU\n", names[k]);
+        }
+    }
+    printf("detected: %s\n", detectSafetyKernels()->name);
+
+    // Equivalência: estados pequenos e aleatórios, com número de recursos variado
+    for (int k = 1; k < count; k++)
+    {
+        mismatches += compareKernelsDirectly(available[k], 10000);
+    }
+    for (int s = 0; s < randomStates; s++)
+    {
+        int customers = 1 + rand() % 40;
+        int resources = 1 + rand() % 40;
+        BankerState *state = randomState(customers, resources);
+        int expectedSequence[customers];
+        int sequence[customers];
+
+        setSafetyKernels(&scalarKernels);
+        int expected = checkSafety(state, expectedSequence);
+        for (int k = 1; k < count; k++)
+        {
+            setSafetyKernels(available[k]);
+            int safe = checkSafety(state, sequence);
+            SafetyEngine *engine = createSafetyEngine(state);
+            int engineSafe = safetyEngineCheck(engine, state, -1);
+            destroySafetyEngine(engine);
+
+            mismatches += safe != expected || engineSafe != expected;
+            mismatches += expected && memcmp(sequence, expectedSequence, sizeof(sequence)) != 0;
+        }
+        destroyBankerState(state);
+    }
+    printf("equivalence: %d random states, %d mismatches\n", randomStates, mismatches);
+
+    // Desempenho: checkSafety no pior caso de ordem (~n²/2 testes de linha inteira)
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            allocationRow(state, i)[j] = 1;
+            needRow(state, i)[j] = j == numberOfResources - 1 ? numberOfCustomers - 1 - i : 0;
+            maximumRow(state, i)[j] = allocationRow(state, i)[j] + needRow(state, i)[j];
+        }
+    }
+
+    printf("%-8s %14s %9s\n", "kernels", "checkSafety ms", "speedup");
+    double scalarTime = 0;
+    for (int k = 0; k < count; k++)
+    {
+        setSafetyKernels(available[k]);
+        double start = nowSeconds();
+        int safe = checkSafety(state, NULL);
+        double elapsed = nowSeconds() - start;
+        if (k == 0)
+        {
+            scalarTime = elapsed;
+        }
+        mismatches += !safe;
+        printf("%-8s %14.2f %8.2fx\n", available[k]->name, elapsed * 1e3, scalarTime / elapsed);
+    }
+
+    destroyBankerState(state);
+    return mismatches != 0;
+}
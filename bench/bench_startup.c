@@ -0,0 +1,173 @@
+// Benchmark da leitura de customer.txt na partida: o caminho antigo (abre o arquivo quatro vezes: teste, contagem de linhas
+// com getline, contagem de colunas com strtok e fgets + strtok + atoi numa linha de 100 bytes) contra loadCustomerFile
+// (um mapeamento, leitura direto para o estado) e loadCompactState. Confere que os três estados são iguais
+// Uso: bench_startup [customers] [resources] [file]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include "banker.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Caminho antigo do main: countNumberOfCustomers
+static int countLines(const char *filename)
+{
+    FILE *file = fopen(filename, "r");
+    int customerCount = 0;
+    char *line = NULL;
+    size_t len = 0;
+    while (getline(&line, &len, file) != -1)
+    {
+        customerCount++;
+    }
+    free(line);
+    fclose(file);
+    return customerCount;
+}
+
+// Caminho antigo do main: countNumberOfResources
+static int countColumns(const char *filename)
+{
+    FILE *file = fopen(filename, "r");
+    char *line = NULL;
+    size_t len = 0;
+    int resourceCount = 0;
+    if (getline(&line, &len, file) != -1)
+    {
+        for (char *token = strtok(line, ","); token != NULL; token = strtok(NULL, ","))
+        {
+            resourceCount++;
+        }
+    }
+    free(line);
+    fclose(file);
+    return resourceCount;
+}
+
+// Caminho antigo completo: teste de abertura, as duas contagens, readCustomerMaximumDemand e o cálculo da NEED
+static BankerState* loadFourPasses(const char *filename, int numberOfResources)
+{
+    FILE *file = fopen(filename, "r");
+    fclose(file);
+    int numberOfCustomers = countLines(filename);
+    if (countColumns(filename) != numberOfResources)
+    {
+        return NULL;
+    }
+
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    file = fopen(filename, "r");
+    char line[100];
+    int currentCustomer = 0;
+    while (fgets(line, sizeof(line), file) != NULL && currentCustomer < numberOfCustomers)
+    {
+        char *token = strtok(line, ",");
+        for (int i = 0; i < numberOfResources && token != NULL; i++)
+        {
+            maximumRow(state, currentCustomer)[i] = atoi(token);
+            token = strtok(NULL, ",");
+        }
+        currentCustomer++;
+    }
+    fclose(file);
+
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            needRow(state, i)[j] = maximumRow(state, i)[j] - allocationRow(state, i)[j];
+        }
+    }
+    return state;
+}
+
+// Linhas diferentes entre o estado antigo e os dois novos
+static long compareStates(const BankerState *expected, const BankerState *state, const CompactState *compact)
+{
+    int numberOfResources = expected->numberOfResources;
+    int maximum[numberOfResources + 1];
+    int allocation[numberOfResources + 1];
+    int need[numberOfResources + 1];
+    long mismatches = 0;
+
+    if (!state || !compact || state->numberOfCustomers != expected->numberOfCustomers
+        || compact->numberOfCustomers != expected->numberOfCustomers)
+    {
+        return 1;
+    }
+    for (int i = 0; i < expected->numberOfCustomers; i++)
+    {
+        size_t bytes = numberOfResources * sizeof(int);
+        getCompactRow(compact, i, maximum, allocation, need);
+        mismatches += memcmp(maximumRow(state, i), maximumRow(expected, i), bytes) != 0
+                      || memcmp(needRow(state, i), needRow(expected, i), bytes) != 0
+                      || memcmp(maximum, maximumRow(expected, i), bytes) != 0
+                      || memcmp(need, needRow(expected, i), bytes) != 0;
+    }
+    return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfCustomers = argc > 1 ? atoi(argv[1]) : 1000000;
+    int numberOfResources = argc > 2 ? atoi(argv[2]) : 8;
+    const char *filename = argc > 3 ? argv[3] : "/tmp/bench_startup_customer.txt";
+
+    // Gera customer.txt com linhas curtas (abaixo dos 100 bytes do caminho antigo, para os dois lerem o mesmo)
+    FILE *file = fopen(filename, "w");
+    if (!file)
+    {
+        printf("Unable to create %s\n", filename);
+        return 1;
+    }
+    srand(42);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            fprintf(file, j ? ",%d" : "%d", rand() % 20);
+        }
+        fprintf(file, "\n");
+    }
+    long bytes = ftell(file);
+    fclose(file);
+
+    // Lê uma vez antes para os três caminhos pegarem o arquivo no page cache
+    CustomerFileStatus status;
+    destroyBankerState(loadCustomerFile(filename, numberOfResources, &status));
+
+    double start = nowSeconds();
+    BankerState *expected = loadFourPasses(filename, numberOfResources);
+    double oldTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    BankerState *state = loadCustomerFile(filename, numberOfResources, &status);
+    double newTime = nowSeconds() - start;
+
+    start = nowSeconds();
+    CompactState *compact = loadCompactState(filename, numberOfResources, &status);
+    double compactTime = nowSeconds() - start;
+
+    long mismatches = expected ? compareStates(expected, state, compact) : 1;
+    double megabytes = bytes / 1e6;
+    printf("%d customers, %d resources, %.1f MB\n", numberOfCustomers, numberOfResources, megabytes);
+    printf("%-26s %10s %10s\n", "loader", "ms", "MB/s");
+    printf("%-26s %10.1f %10.1f\n", "four passes (fgets+strtok)", oldTime * 1e3, megabytes / oldTime);
+    printf("%-26s %10.1f %10.1f\n", "loadCustomerFile", newTime * 1e3, megabytes / newTime);
+    printf("%-26s %10.1f %10.1f\n", "loadCompactState", compactTime * 1e3, megabytes / compactTime);
+    printf("speedup %.2fx (loadCustomerFile), %.2fx (compact), mismatches %ld\n", oldTime / newTime, oldTime / compactTime,
+           mismatches);
+
+    destroyBankerState(expected);
+    destroyBankerState(state);
+    destroyCompactState(compact);
+    remove(filename);
+    return mismatches != 0;
+}
@@ -0,0 +1,160 @@
+// Benchmark das variantes de 4, 8 e 16 recursos (width.c) contra o caminho genérico com os kernels de simd.c
+// Para cada largura: equivalência em estados aleatórios (veredito e sequência segura de checkSafety), checkSafety no pior
+// caso de ordem e uma carga sintética com o motor incremental (admitRequest/admitRelease), conferindo as decisões
+// Uso: bench_width [customers] [commands] [randomStates] [seed]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "workload.h"
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Estado aleatório: alocação abaixo da demanda máxima e recursos disponíveis perto do limite de segurança
+static BankerState* randomState(int numberOfCustomers, int numberOfResources)
+{
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            maximumRow(state, i)[j] = rand() % 10;
+            allocationRow(state, i)[j] = rand() % (maximumRow(state, i)[j] + 1);
+            needRow(state, i)[j] = maximumRow(state, i)[j] - allocationRow(state, i)[j];
+        }
+    }
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        state->availableResources[j] = rand() % 12;
+    }
+    return state;
+}
+
+static int compareRandomStates(const WidthKernels *kernels, int randomStates)
+{
+    int mismatches = 0;
+    for (int s = 0; s < randomStates; s++)
+    {
+        int customers = 1 + rand() % 60;
+        BankerState *state = randomState(customers, kernels->numberOfResources);
+        int expectedSequence[customers];
+        int sequence[customers];
+
+        state->widthKernels = NULL;
+        int expected = checkSafety(state, expectedSequence);
+        state->widthKernels = kernels;
+        int safe = checkSafety(state, sequence);
+        mismatches += safe != expected;
+        mismatches += expected && memcmp(sequence, expectedSequence, sizeof(sequence)) != 0;
+        destroyBankerState(state);
+    }
+    return mismatches;
+}
+
+// checkSafety no pior caso de ordem (~n²/2 testes de linha inteira). Retorna o tempo em segundos
+static double timeWorstOrder(int numberOfCustomers, int numberOfResources, const WidthKernels *kernels, int *mismatches)
+{
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            allocationRow(state, i)[j] = 1;
+            needRow(state, i)[j] = j == numberOfResources - 1 ? numberOfCustomers - 1 - i : 0;
+            maximumRow(state, i)[j] = allocationRow(state, i)[j] + needRow(state, i)[j];
+        }
+    }
+
+    state->widthKernels = kernels;
+    double start = nowSeconds();
+    *mismatches += !checkSafety(state, NULL);
+    double elapsed = nowSeconds() - start;
+    destroyBankerState(state);
+    return elapsed;
+}
+
+// Executa a carga com o motor incremental, guardando as decisões dos RQ. Retorna os ns por comando
+static double timeWorkload(const Workload *workload, const WidthKernels *kernels, RequestDecision *decisions)
+{
+    BankerState *state = copyInitialState(workload);
+    state->widthKernels = kernels;
+    SafetyEngine *engine = createSafetyEngine(state);
+
+    double start = nowSeconds();
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = &workload->commands[k];
+        decisions[k] = REQUEST_GRANTED;
+        if (command->type == COMMAND_REQUEST)
+        {
+            decisions[k] = admitRequest(state, engine, command->customerID, command->resources);
+        }
+        else if (command->type == COMMAND_RELEASE)
+        {
+            admitRelease(state, engine, command->customerID, command->resources);
+        }
+    }
+    double elapsed = nowSeconds() - start;
+
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    return workload->count ? elapsed * 1e9 / workload->count : 0.0;
+}
+
+int main(int argc, char *argv[])
+{
+    int numberOfCustomers = argc > 1 ? atoi(argv[1]) : 2000;
+    long numberOfCommands = argc > 2 ? atol(argv[2]) : 100000;
+    int randomStates = argc > 3 ? atoi(argv[3]) : 2000;
+    unsigned seed = argc > 4 ? (unsigned)atoi(argv[4]) : 42;
+    const int widths[] = { 4, 8, 16 };
+    int mismatches = 0;
+
+    srand(seed);
+    printf("%9s %9s %12s %12s %8s %12s %12s %8s %10s\n", "resources", "customers", "worst ms", "fixed ms", "speedup",
+           "load ns/cmd", "fixed ns/cmd", "speedup", "mismatch");
+    for (int w = 0; w < 3; w++)
+    {
+        const WidthKernels *kernels = findWidthKernels(widths[w]);
+        int widthMismatches = compareRandomStates(kernels, randomStates);
+
+        double genericWorst = timeWorstOrder(numberOfCustomers, widths[w], NULL, &widthMismatches);
+        double fixedWorst = timeWorstOrder(numberOfCustomers, widths[w], kernels, &widthMismatches);
+
+        WorkloadOptions options;
+        defaultWorkloadOptions(&options);
+        options.numberOfCustomers = numberOfCustomers;
+        options.numberOfResources = widths[w];
+        options.numberOfCommands = numberOfCommands;
+        options.seed = seed;
+        Workload *workload = createWorkload(&options);
+        if (!workload)
+        {
+            printf("Unable to generate the workload\n");
+            return 1;
+        }
+        RequestDecision *expected = (RequestDecision *)malloc((workload->count + 1) * sizeof(RequestDecision));
+        RequestDecision *decisions = (RequestDecision *)malloc((workload->count + 1) * sizeof(RequestDecision));
+        double genericLoad = timeWorkload(workload, NULL, expected);
+        double fixedLoad = timeWorkload(workload, kernels, decisions);
+        for (long k = 0; k < workload->count; k++)
+        {
+            widthMismatches += decisions[k] != expected[k];
+        }
+
+        printf("%9d %9d %12.2f %12.2f %7.2fx %12.0f %12.0f %7.2fx %10d\n", widths[w], numberOfCustomers,
+               genericWorst * 1e3, fixedWorst * 1e3, genericWorst / fixedWorst, genericLoad, fixedLoad, genericLoad / fixedLoad,
+               widthMismatches);
+        mismatches += widthMismatches;
+
+        free(expected);
+        free(decisions);
+        destroyWorkload(workload);
+    }
+    return mismatches != 0;
+}
@@ -0,0 +1,386 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "workload.h"
+
+// Os comandos são gerados simulando o banqueiro num estado sombra (com o motor incremental), então a fração de pedidos
+// inseguros é a que o banker vai ver de fato ao executar a carga a partir do estado inicial
+
+#define WORKLOAD_MAXIMUM_DEMAND 20 // Demanda máxima de cada recurso: 0 a 19
+#define WORKLOAD_ATTEMPTS 8        // Clientes tentados antes de desistir de um pedido inseguro ou de uma liberação
+
+static unsigned long nextRandom(unsigned long *rng);
+static int randomBelow(unsigned long *rng, int limit);
+static double randomUnit(unsigned long *rng);
+static int pickCustomer(const WorkloadOptions *options, unsigned long *rng);
+static int makeUnsafeRequest(BankerState *state, SafetyEngine *engine, const WorkloadOptions *options, unsigned long *rng, int *customerID, int *values);
+static void makeSafeRequest(BankerState *state, SafetyEngine *engine, const WorkloadOptions *options, unsigned long *rng, int *customerID, int *values);
+static int makeRelease(BankerState *state, SafetyEngine *engine, const WorkloadOptions *options, unsigned long *rng, int *customerID, int *values);
+
+void defaultWorkloadOptions(WorkloadOptions *options)
+{
+    options->numberOfCustomers = 1000;
+    options->numberOfResources = 8;
+    options->numberOfCommands = 100000;
+    options->skew = 0.0;
+    options->unsafeShare = 0.1;
+    options->releaseShare = 0.3;
+    options->printShare = 0.0001;
+    options->seed = 1;
+}
+
+// Lê uma opção nome=valor (customers, resources, commands, skew, unsafe, release, print, seed). Retorna 0 se não reconhecer
+int parseWorkloadOption(WorkloadOptions *options, const char *argument)
+{
+    const char *value = strchr(argument, '=');
+    if (!value)
+    {
+        return 0;
+    }
+    size_t nameLength = value - argument;
+    value++;
+
+    if (nameLength == 9 && strncmp(argument, "customers", 9) == 0)
+    {
+        options->numberOfCustomers = atoi(value);
+    }
+    else if (nameLength == 9 && strncmp(argument, "resources", 9) == 0)
+    {
+        options->numberOfResources = atoi(value);
+    }
+    else if (nameLength == 8 && strncmp(argument, "commands", 8) == 0)
+    {
+        options->numberOfCommands = atol(value);
+    }
+    else if (nameLength == 4 && strncmp(argument, "skew", 4) == 0)
+    {
+        options->skew = atof(value);
+    }
+    else if (nameLength == 6 && strncmp(argument, "unsafe", 6) == 0)
+    {
+        options->unsafeShare = atof(value);
+    }
+    else if (nameLength == 7 && strncmp(argument, "release", 7) == 0)
+    {
+        options->releaseShare = atof(value);
+    }
+    else if (nameLength == 5 && strncmp(argument, "print", 5) == 0)
+    {
+        options->printShare = atof(value);
+    }
+    else if (nameLength == 4 && strncmp(argument, "seed", 4) == 0)
+    {
+        options->seed = strtoul(value, NULL, 10);
+    }
+    else
+    {
+        return 0;
+    }
+    return options->numberOfCustomers > 0 && options->numberOfResources > 0 && options->numberOfCommands >= 0;
+}
+
+// Gera o estado inicial e a lista de comandos
+Workload* createWorkload(const WorkloadOptions *options)
+{
+    int numberOfCustomers = options->numberOfCustomers;
+    int numberOfResources = options->numberOfResources;
+    unsigned long rng = options->seed * 0x9E3779B97F4A7C15UL + 1;
+
+    Workload *workload = (Workload *)calloc(1, sizeof(Workload));
+    if (!workload)
+    {
+        return NULL;
+    }
+    workload->options = *options;
+    workload->initial = createBankerState(numberOfCustomers, numberOfResources);
+    workload->commands = (Command *)malloc((options->numberOfCommands + 1) * sizeof(Command));
+    workload->values = (int *)malloc(((size_t)options->numberOfCommands + 1) * numberOfResources * sizeof(int));
+    if (!workload->initial || !workload->commands || !workload->values)
+    {
+        destroyWorkload(workload);
+        return NULL;
+    }
+
+    // Demandas aleatórias; os disponíveis cobrem só 1/4 da soma das demandas, então há disputa e pedidos inseguros
+    BankerState *initial = workload->initial;
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        long demand = 0;
+        for (int i = 0; i < numberOfCustomers; i++)
+        {
+            maximumRow(initial, i)[j] = randomBelow(&rng, WORKLOAD_MAXIMUM_DEMAND);
+            needRow(initial, i)[j] = maximumRow(initial, i)[j];
+            demand += maximumRow(initial, i)[j];
+        }
+        initial->availableResources[j] = (int)(demand / 4) + WORKLOAD_MAXIMUM_DEMAND;
+    }
+
+    BankerState *state = copyInitialState(workload);
+    SafetyEngine *engine = state ? createSafetyEngine(state) : NULL;
+    if (!engine)
+    {
+        destroyBankerState(state);
+        destroyWorkload(workload);
+        return NULL;
+    }
+
+    for (long k = 0; k < options->numberOfCommands; k++)
+    {
+        Command *command = &workload->commands[k];
+        int *values = workload->values + (size_t)k * numberOfResources;
+        double dice = randomUnit(&rng);
+        command->resources = values;
+        command->customerID = 0;
+
+        if (dice < options->printShare)
+        {
+            command->type = COMMAND_PRINT;
+            memset(values, 0, numberOfResources * sizeof(int));
+        }
+        else if (dice < options->printShare + options->releaseShare
+                 && makeRelease(state, engine, options, &rng, &command->customerID, values))
+        {
+            command->type = COMMAND_RELEASE;
+        }
+        else
+        {
+            command->type = COMMAND_REQUEST;
+            if (randomUnit(&rng) < options->unsafeShare)
+            {
+                if (makeUnsafeRequest(state, engine, options, &rng, &command->customerID, values))
+                {
+                    workload->unsafeRequests++;
+                }
+                else
+                {
+                    workload->overNeedRequests++;
+                }
+            }
+            else
+            {
+                makeSafeRequest(state, engine, options, &rng, &command->customerID, values);
+            }
+        }
+    }
+    workload->count = options->numberOfCommands;
+
+    destroySafetyEngine(engine);
+    destroyBankerState(state);
+    return workload;
+}
+
+void destroyWorkload(Workload *workload)
+{
+    if (!workload)
+    {
+        return;
+    }
+
+    destroyBankerState(workload->initial);
+    free(workload->commands);
+    free(workload->values);
+    free(workload);
+}
+
+// Cópia do estado inicial para executar a carga
+BankerState* copyInitialState(const Workload *workload)
+{
+    const BankerState *initial = workload->initial;
+    BankerState *state = createBankerState(initial->numberOfCustomers, initial->numberOfResources);
+    if (!state)
+    {
+        return NULL;
+    }
+
+    size_t matrixBytes = (size_t)initial->numberOfCustomers * initial->rowStride * sizeof(int);
+    memcpy(state->maximumDemand, initial->maximumDemand, matrixBytes);
+    memcpy(state->currentAllocation, initial->currentAllocation, matrixBytes);
+    memcpy(state->remainingNeed, initial->remainingNeed, matrixBytes);
+    memcpy(state->availableResources, initial->availableResources, initial->rowStride * sizeof(int));
+    return state;
+}
+
+// Escreve customer.txt, commands.txt e args (os recursos disponíveis para a linha de comando) em directory
+int writeWorkloadFiles(const Workload *workload, const char *directory)
+{
+    const BankerState *initial = workload->initial;
+    int numberOfResources = initial->numberOfResources;
+    char path[4096];
+
+    snprintf(path, sizeof(path), "%s/customer.txt", directory);
+    OutputWriter *writer = openOutputWriter(path);
+    if (!writer)
+    {
+        return 0;
+    }
+    for (int i = 0; i < initial->numberOfCustomers; i++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            writerPutInt(writer, maximumRow(initial, i)[j]);
+            writerPutString(writer, j + 1 < numberOfResources ? "," : "\n");
+        }
+    }
+    if (!closeOutputWriter(writer))
+    {
+        return 0;
+    }
+
+    snprintf(path, sizeof(path), "%s/commands.txt", directory);
+    writer = openOutputWriter(path);
+    if (!writer)
+    {
+        return 0;
+    }
+    for (long k = 0; k < workload->count; k++)
+    {
+        const Command *command = &workload->commands[k];
+        if (command->type == COMMAND_PRINT)
+        {
+            writerPutString(writer, "*\n");
+            continue;
+        }
+        writerPutString(writer, command->type == COMMAND_REQUEST ? "RQ " : "RL ");
+        writerPutInt(writer, command->customerID);
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            writerPutString(writer, " ");
+            writerPutInt(writer, command->resources[j]);
+        }
+        writerPutString(writer, "\n");
+    }
+    if (!closeOutputWriter(writer))
+    {
+        return 0;
+    }
+
+    snprintf(path, sizeof(path), "%s/args", directory);
+    writer = openOutputWriter(path);
+    if (!writer)
+    {
+        return 0;
+    }
+    writerPutVector(writer, initial->availableResources, numberOfResources);
+    writerPutString(writer, "\n");
+    return closeOutputWriter(writer);
+}
+
+// xorshift64*
+static unsigned long nextRandom(unsigned long *rng)
+{
+    unsigned long x = *rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *rng = x;
+    return x * 0x2545F4914F6CDD1DUL;
+}
+
+static int randomBelow(unsigned long *rng, int limit)
+{
+    return limit > 0 ? (int)((nextRandom(rng) >> 33) % (unsigned long)limit) : 0;
+}
+
+static double randomUnit(unsigned long *rng)
+{
+    return (nextRandom(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Cliente do comando: com probabilidade skew, um do 1% mais quente (os primeiros); senão qualquer um
+static int pickCustomer(const WorkloadOptions *options, unsigned long *rng)
+{
+    int hot = options->numberOfCustomers / 100 > 0 ? options->numberOfCustomers / 100 : 1;
+    if (randomUnit(rng) < options->skew)
+    {
+        return randomBelow(rng, hot);
+    }
+    return randomBelow(rng, options->numberOfCustomers);
+}
+
+// Pedido que leva a um estado inseguro: o cliente tenta pegar toda a NEED que cabe nos disponíveis
+// Se nenhum cliente tentado tem um pedido assim, gera um pedido acima da NEED (também negado) e retorna 0
+static int makeUnsafeRequest(BankerState *state, SafetyEngine *engine, const WorkloadOptions *options, unsigned long *rng, int *customerID, int *values)
+{
+    int numberOfResources = state->numberOfResources;
+    for (int attempt = 0; attempt < WORKLOAD_ATTEMPTS; attempt++)
+    {
+        int customer = pickCustomer(options, rng);
+        const int *need = needRow(state, customer);
+        int total = 0;
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            values[j] = need[j] < state->availableResources[j] ? need[j] : state->availableResources[j];
+            total += values[j];
+        }
+        if (total == 0)
+        {
+            continue;
+        }
+
+        RequestDecision decision = admitRequest(state, engine, customer, values);
+        if (decision == REQUEST_UNSAFE)
+        {
+            *customerID = customer;
+            return 1;
+        }
+        if (decision == REQUEST_GRANTED)
+        {
+            admitRelease(state, engine, customer, values); // Era seguro: desfaz e tenta outro cliente
+        }
+    }
+
+    *customerID = pickCustomer(options, rng);
+    int resource = randomBelow(rng, numberOfResources);
+    memset(values, 0, numberOfResources * sizeof(int));
+    values[resource] = needRow(state, *customerID)[resource] + 1;
+    return 0;
+}
+
+// Pedido pequeno que cabe na NEED e nos disponíveis e mantém o estado seguro (aplicado no estado sombra)
+static void makeSafeRequest(BankerState *state, SafetyEngine *engine, const WorkloadOptions *options, unsigned long *rng, int *customerID, int *values)
+{
+    int numberOfResources = state->numberOfResources;
+    for (int attempt = 0; attempt < WORKLOAD_ATTEMPTS; attempt++)
+    {
+        int customer = pickCustomer(options, rng);
+        const int *need = needRow(state, customer);
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            int limit = need[j] < state->availableResources[j] ? need[j] : state->availableResources[j];
+            values[j] = randomBelow(rng, (limit < 3 ? limit : 3) + 1);
+        }
+        if (admitRequest(state, engine, customer, values) == REQUEST_GRANTED)
+        {
+            *customerID = customer;
+            return;
+        }
+    }
+
+    // Pedido vazio: sempre aceito num estado seguro
+    *customerID = pickCustomer(options, rng);
+    memset(values, 0, numberOfResources * sizeof(int));
+}
+
+// Liberação de parte do que um cliente tem (aplicada no estado sombra). Retorna 0 se os clientes tentados não têm nada
+static int makeRelease(BankerState *state, SafetyEngine *engine, const WorkloadOptions *options, unsigned long *rng, int *customerID, int *values)
+{
+    int numberOfResources = state->numberOfResources;
+    for (int attempt = 0; attempt < WORKLOAD_ATTEMPTS; attempt++)
+    {
+        int customer = pickCustomer(options, rng);
+        const int *allocation = allocationRow(state, customer);
+        int total = 0;
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            values[j] = randomBelow(rng, allocation[j] + 1);
+            total += values[j];
+        }
+        if (total > 0)
+        {
+            admitRelease(state, engine, customer, values);
+            *customerID = customer;
+            return 1;
+        }
+    }
+    return 0;
+}
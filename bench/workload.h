@@ -0,0 +1,39 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "banker.h"
+
+// Gerador de cargas sintéticas para os benchmarks (workload.c): matrizes de clientes e listas de comandos RQ/RL/*
+// A mesma semente gera sempre a mesma carga (o gerador não usa rand(), que muda entre bibliotecas C)
+typedef struct
+{
+    int numberOfCustomers;
+    int numberOfResources;
+    long numberOfCommands;
+    double skew;           // Fração dos comandos que vão para o 1% de clientes mais quentes (0 = uniforme)
+    double unsafeShare;    // Fração dos RQ que levariam a um estado inseguro (negados)
+    double releaseShare;   // Fração dos comandos que são RL
+    double printShare;     // Fração dos comandos que são *
+    unsigned long seed;
+} WorkloadOptions;
+
+typedef struct
+{
+    WorkloadOptions options;
+    BankerState *initial;  // Demanda máxima, NEED e disponíveis iniciais (alocação zero)
+    Command *commands;
+    int *values;           // numberOfCommands x numberOfResources
+    long count;
+    long unsafeRequests;   // RQ gerados para serem negados por segurança
+    long overNeedRequests; // RQ "inseguros" que viraram pedidos acima da NEED (nenhum cliente tinha um pedido inseguro)
+} Workload;
+
+// Declaração das Funções
+void defaultWorkloadOptions(WorkloadOptions *options);
+int parseWorkloadOption(WorkloadOptions *options, const char *argument);
+Workload* createWorkload(const WorkloadOptions *options);
+void destroyWorkload(Workload *workload);
+BankerState* copyInitialState(const Workload *workload);
+int writeWorkloadFiles(const Workload *workload, const char *directory);
+
+#endif
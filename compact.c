@@ -0,0 +1,569 @@
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+// Estado compacto: as mesmas decisões do BankerState com bem menos memória quando os valores são pequenos
+// (1M clientes x 32 recursos: 384 MB em int com as três matrizes, 64 MB com células de 8 bits e sem a NEED)
+// Um pedido ou liberação que deixaria a alocação fora da célula (negativa ou acima do limite) não é aplicado: as funções
+// retornam 0 e quem chama interrompe o processamento
+
+static const int groupLimit[COMPACT_GROUPS] = { UINT8_MAX, UINT16_MAX, INT_MAX }; // 32 bits até INT_MAX: as contas são em int
+
+static int compactNeedFitsWork(const CompactState *state, int customerID, const int *work);
+static void compactAddToWork(const CompactState *state, int customerID, int *work);
+static void readCompactRow(const CompactState *state, int customerID, int *maximum, int *allocation);
+static void writeCompactAllocation(CompactState *state, int customerID, const int *allocation);
+static int isCompactSafe(CompactState *state, int customerID, const int *allocation, const int *need, const int *available);
+static int checkFits(const CompactState *state, int customerID, int overlayCustomer, const int *overlayNeed, const int *work);
+static void addFinished(const CompactState *state, int customerID, int overlayCustomer, const int *overlayAllocation, int *work);
+
+// Cria o estado com a largura de cada recurso escolhida pelo maior valor da coluna (columnMaximum, na ordem original)
+// A demanda máxima e a alocação começam zeradas; os valores vêm depois com setCompactMaximumRow
+CompactState* createCompactState(int numberOfCustomers, int numberOfResources, const int *columnMaximum)
+{
+    CompactState *state = (CompactState *)calloc(1, sizeof(CompactState));
+    if (!state)
+    {
+        return NULL;
+    }
+    state->numberOfCustomers = numberOfCustomers;
+    state->numberOfResources = numberOfResources;
+    state->resourceOrder = (int *)malloc((numberOfResources + 1) * sizeof(int));
+    state->cellLimit = (int *)malloc((numberOfResources + 1) * sizeof(int));
+    state->available = (int *)calloc(numberOfResources + 1, sizeof(int));
+    state->work = (int *)calloc(numberOfResources + 1, sizeof(int));
+    state->safeSequence = (int *)malloc((numberOfCustomers + 1) * sizeof(int));
+    state->candidateSequence = (int *)malloc((numberOfCustomers + 1) * sizeof(int));
+    state->finished = (uint8_t *)malloc(numberOfCustomers + 1);
+    if (!state->resourceOrder || !state->cellLimit || !state->available || !state->work
+        || !state->safeSequence || !state->candidateSequence || !state->finished)
+    {
+        destroyCompactState(state);
+        return NULL;
+    }
+
+    // Ordem compacta: os recursos de 8 bits, depois os de 16 e os de 32, cada grupo na ordem original
+    int position = 0;
+    for (int g = 0; g < COMPACT_GROUPS; g++)
+    {
+        for (int j = 0; j < numberOfResources; j++)
+        {
+            int group = columnMaximum[j] <= UINT8_MAX ? 0 : columnMaximum[j] <= UINT16_MAX ? 1 : 2;
+            if (group == g)
+            {
+                state->resourceOrder[position] = j;
+                state->cellLimit[position] = groupLimit[g];
+                position++;
+                state->groupSize[g]++;
+            }
+        }
+    }
+
+    size_t cells[COMPACT_GROUPS];
+    for (int g = 0; g < COMPACT_GROUPS; g++)
+    {
+        cells[g] = (size_t)numberOfCustomers * state->groupSize[g] + 1;
+    }
+    state->maximum8 = (uint8_t *)calloc(cells[0], sizeof(uint8_t));
+    state->allocation8 = (uint8_t *)calloc(cells[0], sizeof(uint8_t));
+    state->maximum16 = (uint16_t *)calloc(cells[1], sizeof(uint16_t));
+    state->allocation16 = (uint16_t *)calloc(cells[1], sizeof(uint16_t));
+    state->maximum32 = (uint32_t *)calloc(cells[2], sizeof(uint32_t));
+    state->allocation32 = (uint32_t *)calloc(cells[2], sizeof(uint32_t));
+    if (!state->maximum8 || !state->allocation8 || !state->maximum16 || !state->allocation16
+        || !state->maximum32 || !state->allocation32)
+    {
+        destroyCompactState(state);
+        return NULL;
+    }
+    return state;
+}
+
+void destroyCompactState(CompactState *state)
+{
+    if (!state)
+    {
+        return;
+    }
+
+    free(state->resourceOrder);
+    free(state->cellLimit);
+    free(state->available);
+    free(state->work);
+    free(state->safeSequence);
+    free(state->candidateSequence);
+    free(state->finished);
+    free(state->maximum8);
+    free(state->allocation8);
+    free(state->maximum16);
+    free(state->allocation16);
+    free(state->maximum32);
+    free(state->allocation32);
+    free(state);
+}
+
+// Lê customer.txt direto para o estado compacto, sem passar por matrizes int. O arquivo é mapeado uma vez: uma passada
+// acha o maior valor de cada coluna (que escolhe a largura) e a segunda preenche as células
+// Retorna NULL (com o motivo em *status) nos casos de loadCustomerFile ou se algum valor é negativo
+CompactState* loadCompactState(const char *filename, int numberOfResources, CustomerFileStatus *status)
+{
+    MappedFile file;
+    if (!mapFile(filename, &file))
+    {
+        *status = CUSTOMERS_UNREADABLE;
+        return NULL;
+    }
+
+    int numberOfCustomers;
+    int fileNumberOfResources;
+    measureCustomerFile(file.data, file.size, &numberOfCustomers, &fileNumberOfResources);
+    if (fileNumberOfResources != numberOfResources)
+    {
+        unmapFile(&file);
+        *status = CUSTOMERS_WIDTH_MISMATCH;
+        return NULL;
+    }
+
+    int row[numberOfResources + 1];
+    int columnMaximum[numberOfResources + 1];
+    const char *cursor = file.data;
+    const char *end = file.data + file.size;
+    memset(columnMaximum, 0, sizeof(columnMaximum));
+
+    *status = CUSTOMERS_LOADED;
+    for (int i = 0; i < numberOfCustomers && *status == CUSTOMERS_LOADED; i++)
+    {
+        if (!parseCustomerRow(&cursor, end, row, numberOfResources))
+        {
+            *status = CUSTOMERS_MALFORMED;
+        }
+        for (int j = 0; j < numberOfResources && *status == CUSTOMERS_LOADED; j++)
+        {
+            if (row[j] < 0)
+            {
+                *status = CUSTOMERS_NEGATIVE;
+            }
+            else if (row[j] > columnMaximum[j])
+            {
+                columnMaximum[j] = row[j];
+            }
+        }
+    }
+    if (*status != CUSTOMERS_LOADED)
+    {
+        unmapFile(&file);
+        return NULL;
+    }
+
+    CompactState *state = createCompactState(numberOfCustomers, numberOfResources, columnMaximum);
+    cursor = file.data;
+    for (int i = 0; state && i < numberOfCustomers; i++)
+    {
+        parseCustomerRow(&cursor, end, row, numberOfResources);
+        setCompactMaximumRow(state, i, row);
+    }
+
+    unmapFile(&file);
+    if (!state)
+    {
+        *status = CUSTOMERS_NO_MEMORY;
+    }
+    return state;
+}
+
+// Bytes das matrizes e dos vetores por cliente (o que cresce com o número de clientes)
+size_t compactStateBytes(const CompactState *state)
+{
+    size_t customers = state->numberOfCustomers;
+    size_t cellBytes = state->groupSize[0] * sizeof(uint8_t) + state->groupSize[1] * sizeof(uint16_t)
+                       + state->groupSize[2] * sizeof(uint32_t);
+    return customers * cellBytes * 2 + customers * (2 * sizeof(int) + sizeof(uint8_t));
+}
+
+// Guarda a demanda máxima de um cliente (na ordem original; cada valor tem que caber na largura do seu recurso)
+void setCompactMaximumRow(CompactState *state, int customerID, const int *maximum)
+{
+    size_t i = customerID;
+    int k = 0;
+    for (int c = 0; c < state->groupSize[0]; c++, k++)
+    {
+        state->maximum8[i * state->groupSize[0] + c] = (uint8_t)maximum[state->resourceOrder[k]];
+    }
+    for (int c = 0; c < state->groupSize[1]; c++, k++)
+    {
+        state->maximum16[i * state->groupSize[1] + c] = (uint16_t)maximum[state->resourceOrder[k]];
+    }
+    for (int c = 0; c < state->groupSize[2]; c++, k++)
+    {
+        state->maximum32[i * state->groupSize[2] + c] = (uint32_t)maximum[state->resourceOrder[k]];
+    }
+    state->hasSafeSequence = 0;
+}
+
+// Recursos disponíveis na ordem original
+void setCompactAvailable(CompactState *state, const int *available)
+{
+    for (int k = 0; k < state->numberOfResources; k++)
+    {
+        state->available[k] = available[state->resourceOrder[k]];
+    }
+    state->hasSafeSequence = 0;
+}
+
+void getCompactAvailable(const CompactState *state, int *available)
+{
+    for (int k = 0; k < state->numberOfResources; k++)
+    {
+        available[state->resourceOrder[k]] = state->available[k];
+    }
+}
+
+// Linha de um cliente expandida para int, na ordem original (para imprimir)
+void getCompactRow(const CompactState *state, int customerID, int *maximum, int *allocation, int *need)
+{
+    int numberOfResources = state->numberOfResources;
+    int compactMaximum[numberOfResources + 1];
+    int compactAllocation[numberOfResources + 1];
+    readCompactRow(state, customerID, compactMaximum, compactAllocation);
+    for (int k = 0; k < numberOfResources; k++)
+    {
+        int j = state->resourceOrder[k];
+        maximum[j] = compactMaximum[k];
+        allocation[j] = compactAllocation[k];
+        need[j] = compactMaximum[k] - compactAllocation[k];
+    }
+}
+
+// Decide um pedido RQ com as regras de admitRequest (request na ordem original); se aceito, fica aplicado
+// Retorna 0 sem mudar nada se a alocação depois do pedido não caberia nas células (só com valores negativos)
+int compactAdmitRequest(CompactState *state, int customerID, const int *request, RequestDecision *decision)
+{
+    int numberOfResources = state->numberOfResources;
+    int maximum[numberOfResources + 1];
+    int allocation[numberOfResources + 1];
+    int need[numberOfResources + 1];
+    int available[numberOfResources + 1];
+
+    STATS_COUNT(requests);
+    readCompactRow(state, customerID, maximum, allocation);
+
+    // Mesmos limites de checkRequestLimits: primeiro a NEED, depois os disponíveis
+    *decision = REQUEST_GRANTED;
+    for (int k = 0; k < numberOfResources && *decision == REQUEST_GRANTED; k++)
+    {
+        if (request[state->resourceOrder[k]] > maximum[k] - allocation[k])
+        {
+            *decision = REQUEST_EXCEEDS_NEED;
+        }
+    }
+    for (int k = 0; k < numberOfResources && *decision == REQUEST_GRANTED; k++)
+    {
+        if (request[state->resourceOrder[k]] > state->available[k])
+        {
+            *decision = REQUEST_NOT_AVAILABLE;
+        }
+    }
+    if (*decision != REQUEST_GRANTED)
+    {
+        STATS_DECISION(*decision);
+        return 1;
+    }
+
+    for (int k = 0; k < numberOfResources; k++)
+    {
+        int amount = request[state->resourceOrder[k]];
+        if (allocation[k] + amount < 0 || allocation[k] + amount > state->cellLimit[k])
+        {
+            return 0; // Não cabe na célula
+        }
+        allocation[k] += amount;
+        need[k] = maximum[k] - allocation[k];
+        available[k] = state->available[k] - amount;
+    }
+
+    // A checagem vê o pedido como um overlay; o estado só muda se for seguro
+    STATS_TIMER_START(timer);
+    int safe = isCompactSafe(state, customerID, allocation, need, available);
+    STATS_TIMER_STOP(timer);
+    if (!safe)
+    {
+        *decision = REQUEST_UNSAFE;
+        STATS_DECISION(REQUEST_UNSAFE);
+        return 1;
+    }
+
+    writeCompactAllocation(state, customerID, allocation);
+    memcpy(state->available, available, numberOfResources * sizeof(int));
+    STATS_DECISION(REQUEST_GRANTED);
+    return 1;
+}
+
+// Decide uma liberação RL com as regras de admitRelease (release na ordem original); *released = 1 se foi aplicada
+// Retorna 0 sem mudar nada se a alocação depois da liberação não caberia nas células (só com valores negativos)
+int compactAdmitRelease(CompactState *state, int customerID, const int *release, int *released)
+{
+    int numberOfResources = state->numberOfResources;
+    int maximum[numberOfResources + 1];
+    int allocation[numberOfResources + 1];
+    int negative = 0;
+
+    STATS_COUNT(releases);
+    readCompactRow(state, customerID, maximum, allocation);
+    *released = 0;
+    for (int k = 0; k < numberOfResources; k++)
+    {
+        if (release[state->resourceOrder[k]] > allocation[k])
+        {
+            STATS_COUNT(releasesDenied);
+            return 1;
+        }
+    }
+    for (int k = 0; k < numberOfResources; k++)
+    {
+        int amount = release[state->resourceOrder[k]];
+        if (allocation[k] - amount > state->cellLimit[k])
+        {
+            return 0; // Não cabe na célula
+        }
+        allocation[k] -= amount;
+        negative |= amount < 0;
+    }
+
+    writeCompactAllocation(state, customerID, allocation);
+    for (int k = 0; k < numberOfResources; k++)
+    {
+        state->available[k] += release[state->resourceOrder[k]];
+    }
+
+    // Devolver recursos mantém a sequência segura guardada; um valor negativo (que aloca mais) pode invalidá-la
+    if (negative)
+    {
+        state->hasSafeSequence = 0;
+    }
+    *released = 1;
+    return 1;
+}
+
+// Checa o estado com a linha de customerID trocada por allocation/need e com os disponíveis available (ordem compacta)
+// Caminho rápido e sequência guardada como no motor incremental; o reparo termina, a cada passada, todos os clientes que
+// cabem em work (sem alocação negativa, terminar um cliente só aumenta work e a ordem não muda o veredito)
+static int isCompactSafe(CompactState *state, int customerID, const int *allocation, const int *need, const int *available)
+{
+    int numberOfCustomers = state->numberOfCustomers;
+    int numberOfResources = state->numberOfResources;
+    int *work = state->work;
+    uint8_t *finished = state->finished;
+    int *sequence = state->candidateSequence;
+    int completed = 0;
+
+    // O estado antes do pedido era seguro e o cliente termina já com os disponíveis: continua seguro (ver safety.c)
+    if (state->hasSafeSequence && checkFits(state, customerID, customerID, need, available))
+    {
+        int length = 1;
+        sequence[0] = customerID;
+        for (int k = 0; k < numberOfCustomers; k++)
+        {
+            if (state->safeSequence[k] != customerID)
+            {
+                sequence[length++] = state->safeSequence[k];
+            }
+        }
+        state->candidateSequence = state->safeSequence;
+        state->safeSequence = sequence;
+        state->fastApprovals++;
+        STATS_COUNT(fastApprovals);
+        STATS_PASSES(0);
+        return 1;
+    }
+
+    memcpy(work, available, numberOfResources * sizeof(int));
+    memset(finished, 0, numberOfCustomers);
+
+    // Percorre a sequência guardada até o primeiro cliente que não cabe
+    if (state->hasSafeSequence)
+    {
+        while (completed < numberOfCustomers)
+        {
+            int i = state->safeSequence[completed];
+            if (!checkFits(state, i, customerID, need, work))
+            {
+                break;
+            }
+            addFinished(state, i, customerID, allocation, work);
+            finished[i] = 1;
+            sequence[completed++] = i;
+        }
+        if (completed == numberOfCustomers)
+        {
+            state->cacheHits++;
+            STATS_COUNT(cacheHits);
+            STATS_PASSES(1);
+            return 1;
+        }
+    }
+    state->cacheMisses++;
+    STATS_COUNT(cacheMisses);
+
+    // Reparo: passadas sobre os clientes que faltam até todos terminarem ou uma passada não terminar ninguém
+    int passes = state->hasSafeSequence;
+    while (completed < numberOfCustomers)
+    {
+        int progress = 0;
+        passes++;
+        for (int i = 0; i < numberOfCustomers; i++)
+        {
+            if (!finished[i] && checkFits(state, i, customerID, need, work))
+            {
+                addFinished(state, i, customerID, allocation, work);
+                finished[i] = 1;
+                sequence[completed++] = i;
+                progress = 1;
+            }
+        }
+        if (!progress)
+        {
+            STATS_PASSES(passes);
+            return 0;
+        }
+    }
+
+    STATS_PASSES(passes);
+    state->candidateSequence = state->safeSequence;
+    state->safeSequence = sequence;
+    state->hasSafeSequence = 1;
+    return 1;
+}
+
+// NEED de customerID cabe em work? O cliente do overlay usa overlayNeed, os outros as células
+static int checkFits(const CompactState *state, int customerID, int overlayCustomer, const int *overlayNeed, const int *work)
+{
+    if (customerID != overlayCustomer)
+    {
+        return compactNeedFitsWork(state, customerID, work);
+    }
+    for (int k = 0; k < state->numberOfResources; k++)
+    {
+        if (overlayNeed[k] > work[k])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void addFinished(const CompactState *state, int customerID, int overlayCustomer, const int *overlayAllocation, int *work)
+{
+    if (customerID != overlayCustomer)
+    {
+        compactAddToWork(state, customerID, work);
+        return;
+    }
+    for (int k = 0; k < state->numberOfResources; k++)
+    {
+        work[k] += overlayAllocation[k];
+    }
+}
+
+// NEED (máximo - alocação) cabe em work, grupo por grupo
+static int compactNeedFitsWork(const CompactState *state, int customerID, const int *work)
+{
+    size_t i = customerID;
+    const uint8_t *maximum8 = state->maximum8 + i * state->groupSize[0];
+    const uint8_t *allocation8 = state->allocation8 + i * state->groupSize[0];
+    for (int c = 0; c < state->groupSize[0]; c++)
+    {
+        if (maximum8[c] - allocation8[c] > work[c])
+        {
+            return 0;
+        }
+    }
+    work += state->groupSize[0];
+
+    const uint16_t *maximum16 = state->maximum16 + i * state->groupSize[1];
+    const uint16_t *allocation16 = state->allocation16 + i * state->groupSize[1];
+    for (int c = 0; c < state->groupSize[1]; c++)
+    {
+        if (maximum16[c] - allocation16[c] > work[c])
+        {
+            return 0;
+        }
+    }
+    work += state->groupSize[1];
+
+    const uint32_t *maximum32 = state->maximum32 + i * state->groupSize[2];
+    const uint32_t *allocation32 = state->allocation32 + i * state->groupSize[2];
+    for (int c = 0; c < state->groupSize[2]; c++)
+    {
+        if ((int)maximum32[c] - (int)allocation32[c] > work[c])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void compactAddToWork(const CompactState *state, int customerID, int *work)
+{
+    size_t i = customerID;
+    const uint8_t *allocation8 = state->allocation8 + i * state->groupSize[0];
+    for (int c = 0; c < state->groupSize[0]; c++)
+    {
+        work[c] += allocation8[c];
+    }
+    work += state->groupSize[0];
+
+    const uint16_t *allocation16 = state->allocation16 + i * state->groupSize[1];
+    for (int c = 0; c < state->groupSize[1]; c++)
+    {
+        work[c] += allocation16[c];
+    }
+    work += state->groupSize[1];
+
+    const uint32_t *allocation32 = state->allocation32 + i * state->groupSize[2];
+    for (int c = 0; c < state->groupSize[2]; c++)
+    {
+        work[c] += (int)allocation32[c];
+    }
+}
+
+// Demanda máxima e alocação de um cliente em int, na ordem compacta
+static void readCompactRow(const CompactState *state, int customerID, int *maximum, int *allocation)
+{
+    size_t i = customerID;
+    int k = 0;
+    for (int c = 0; c < state->groupSize[0]; c++, k++)
+    {
+        maximum[k] = state->maximum8[i * state->groupSize[0] + c];
+        allocation[k] = state->allocation8[i * state->groupSize[0] + c];
+    }
+    for (int c = 0; c < state->groupSize[1]; c++, k++)
+    {
+        maximum[k] = state->maximum16[i * state->groupSize[1] + c];
+        allocation[k] = state->allocation16[i * state->groupSize[1] + c];
+    }
+    for (int c = 0; c < state->groupSize[2]; c++, k++)
+    {
+        maximum[k] = (int)state->maximum32[i * state->groupSize[2] + c];
+        allocation[k] = (int)state->allocation32[i * state->groupSize[2] + c];
+    }
+}
+
+// Grava a alocação (ordem compacta, já conferida contra cellLimit)
+static void writeCompactAllocation(CompactState *state, int customerID, const int *allocation)
+{
+    size_t i = customerID;
+    int k = 0;
+    for (int c = 0; c < state->groupSize[0]; c++, k++)
+    {
+        state->allocation8[i * state->groupSize[0] + c] = (uint8_t)allocation[k];
+    }
+    for (int c = 0; c < state->groupSize[1]; c++, k++)
+    {
+        state->allocation16[i * state->groupSize[1] + c] = (uint16_t)allocation[k];
+    }
+    for (int c = 0; c < state->groupSize[2]; c++, k++)
+    {
+        state->allocation32[i * state->groupSize[2] + c] = (uint32_t)allocation[k];
+    }
+}
@@ -0,0 +1,428 @@
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+// Núcleo do banqueiro para várias threads decidindo pedidos e liberações ao mesmo tempo sobre o mesmo BankerState
+//
+// Liberação: usa um spinlock por cliente (customerLock), não é lock-free. Com ele, a conferência release <= alocação e a
+// escrita da linha são uma coisa só para as outras liberações e commits do mesmo cliente (sem ele, uma liberação veria a linha
+// de outra pela metade e poderia ser negada sem motivo). Nos disponíveis soma com adições atômicas, e não há lock global:
+// liberações de clientes diferentes não esperam umas pelas outras.
+//
+// Pedido (otimista): atualiza o snapshot do worker até uma cópia consistente, decide sem lock nenhum e, se aceito, faz o
+// commit com um CAS na versão dos pedidos (a escrita da linha usa o mesmo lock do cliente da liberação); se outro pedido foi aplicado depois do snapshot, o CAS falha e o pedido é
+// decidido de novo. Cada linha tem uma versão, então o snapshot só copia as linhas que mudaram desde o anterior, e o
+// pedido é checado como um overlay pelo motor incremental do worker (como em admitRequest), sem bankerAlgorithm completo.
+// Liberações concluídas depois do snapshot não invalidam o commit: devolver recursos mantém seguro um estado seguro
+// (com alocações não negativas), e só aumentam NEED e disponíveis, então os limites do pedido continuam valendo.
+//
+// Linearização: uma negação vale no instante do snapshot; um pedido aceito, no commit; uma liberação, no início da escrita.
+// Com alocação negativa no snapshot, ou liberação com valor negativo, essas garantias não valem e o commit também exige que
+// nenhuma liberação tenha começado desde o snapshot (liberações negativas passam pela versão dos pedidos).
+//
+// Os valores das matrizes são lidos e escritos com atomics relaxados; a ordem vem das barreiras em volta (como num seqlock).
+// order (opcional) recebe um número crescente tirado no ponto de linearização, para checar as decisões contra uma execução serial.
+
+#define CACHE_LINE 64
+
+struct ConcurrentBanker
+{
+    BankerState *state;
+    long grantVersion __attribute__((aligned(CACHE_LINE)));     // Ímpar enquanto um pedido aceito é aplicado
+    long releasesStarted __attribute__((aligned(CACHE_LINE)));  // Liberações que começaram a escrever
+    long releasesFinished __attribute__((aligned(CACHE_LINE))); // Liberações que terminaram de escrever
+    long orderCounter __attribute__((aligned(CACHE_LINE)));     // Fonte dos números de linearização
+    int *customerLock;                                          // Spinlock de cada cliente: 1 enquanto a linha está sendo escrita
+    long *rowVersion;                                           // Escritas concluídas na linha do cliente
+};
+
+static void lockCustomer(ConcurrentBanker *banker, int customerID);
+static void unlockCustomer(ConcurrentBanker *banker, int customerID);
+static void backOff(int *spins);
+static long takeOrder(ConcurrentBanker *banker, long *order);
+static void takeSnapshot(ConcurrentWorker *worker, long *grantVersion, long *releases, long *order);
+static void copyRow(ConcurrentWorker *worker, int customerID, long version);
+static long applyChange(ConcurrentBanker *banker, int customerID, const int *values, int sign);
+static int releaseLocked(ConcurrentBanker *banker, int customerID, const int *release, long *order);
+
+// Cria o núcleo concorrente sobre um estado já preenchido (o estado continua sendo de quem chama)
+ConcurrentBanker* createConcurrentBanker(BankerState *state)
+{
+    ConcurrentBanker *banker = (ConcurrentBanker *)aligned_alloc(CACHE_LINE, (sizeof(ConcurrentBanker) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+    if (!banker)
+    {
+        return NULL;
+    }
+
+    banker->state = state;
+    banker->grantVersion = 0;
+    banker->releasesStarted = 0;
+    banker->releasesFinished = 0;
+    banker->orderCounter = 0;
+    banker->customerLock = (int *)calloc(state->numberOfCustomers, sizeof(int));
+    banker->rowVersion = (long *)calloc(state->numberOfCustomers, sizeof(long));
+    if (!banker->customerLock || !banker->rowVersion)
+    {
+        destroyConcurrentBanker(banker);
+        return NULL;
+    }
+    return banker;
+}
+
+void destroyConcurrentBanker(ConcurrentBanker *banker)
+{
+    if (!banker)
+    {
+        return;
+    }
+
+    free(banker->customerLock);
+    free(banker->rowVersion);
+    free(banker);
+}
+
+// Área de uma thread: o snapshot onde os pedidos são decididos, o motor sobre ele e os contadores de novas tentativas
+// O primeiro snapshot copia todas as linhas (nenhuma versão é -1)
+ConcurrentWorker* createConcurrentWorker(ConcurrentBanker *banker)
+{
+    int numberOfCustomers = banker->state->numberOfCustomers;
+    ConcurrentWorker *worker = (ConcurrentWorker *)calloc(1, sizeof(ConcurrentWorker));
+    if (!worker)
+    {
+        return NULL;
+    }
+
+    worker->banker = banker;
+    worker->snapshot = createBankerState(numberOfCustomers, banker->state->numberOfResources);
+    worker->engine = worker->snapshot ? createSafetyEngine(worker->snapshot) : NULL;
+    worker->rowVersion = (long *)malloc(numberOfCustomers * sizeof(long));
+    worker->changedRows = (int *)malloc(numberOfCustomers * sizeof(int));
+    worker->rowChanged = (int *)calloc(numberOfCustomers, sizeof(int));
+    if (!worker->engine || !worker->rowVersion || !worker->changedRows || !worker->rowChanged)
+    {
+        destroyConcurrentWorker(worker);
+        return NULL;
+    }
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        worker->rowVersion[i] = -1;
+    }
+    return worker;
+}
+
+void destroyConcurrentWorker(ConcurrentWorker *worker)
+{
+    if (!worker)
+    {
+        return;
+    }
+
+    destroySafetyEngine(worker->engine);
+    destroyBankerState(worker->snapshot);
+    free(worker->rowVersion);
+    free(worker->changedRows);
+    free(worker->rowChanged);
+    free(worker);
+}
+
+// Decide um pedido RQ com as mesmas regras de admitRequest. Se aceito, fica aplicado no estado compartilhado
+RequestDecision concurrentRequest(ConcurrentWorker *worker, int customerID, const int *request, long *order)
+{
+    ConcurrentBanker *banker = worker->banker;
+    BankerState *snapshot = worker->snapshot;
+    SafetyEngine *engine = worker->engine;
+    int numberOfResources = snapshot->numberOfResources;
+    int rowLength = snapshot->rowStride;
+    int available[rowLength];
+    int allocation[rowLength];
+    int need[rowLength];
+
+    STATS_COUNT(requests);
+    while (1)
+    {
+        long grantVersion;
+        long releases;
+        takeSnapshot(worker, &grantVersion, &releases, order);
+        int negativeAllocation = engine->negativeAllocationCount > 0;
+
+        // Decide no snapshot, sem lock: a linha nova do cliente fica fora do snapshot (overlay), como em admitRequest
+        RequestDecision decision = checkRequestLimits(snapshot, customerID, request);
+        if (decision == REQUEST_GRANTED)
+        {
+            memcpy(available, snapshot->availableResources, rowLength * sizeof(int));
+            memcpy(allocation, allocationRow(snapshot, customerID), rowLength * sizeof(int));
+            memcpy(need, needRow(snapshot, customerID), rowLength * sizeof(int));
+            for (int j = 0; j < numberOfResources; j++)
+            {
+                available[j] -= request[j];
+                allocation[j] += request[j];
+                need[j] -= request[j];
+            }
+            SafetyOverlay overlay = { customerID, available, allocation, need };
+            STATS_TIMER_START(timer);
+            int safe = safetyEngineCheckOverlay(engine, snapshot, &overlay);
+            STATS_TIMER_STOP(timer);
+            if (!safe)
+            {
+                decision = REQUEST_UNSAFE;
+            }
+        }
+        if (decision != REQUEST_GRANTED)
+        {
+            STATS_DECISION(decision);
+            return decision; // Linearizado no snapshot (order já foi preenchido por takeSnapshot)
+        }
+
+        // Commit: só vale se nenhum outro pedido foi aplicado desde o snapshot
+        // Se não vale, a sequência que o motor guardou (a do snapshot com o pedido) é descartada
+        if (!__atomic_compare_exchange_n(&banker->grantVersion, &grantVersion, grantVersion + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+            engine->hasSafeSequence = 0;
+            worker->conflicts++;
+            STATS_COUNT(commitConflicts);
+            continue;
+        }
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        lockCustomer(banker, customerID);
+        takeOrder(banker, order);
+        if (negativeAllocation && __atomic_load_n(&banker->releasesStarted, __ATOMIC_SEQ_CST) != releases)
+        {
+            // Com alocação negativa, uma liberação depois do snapshot pode mudar o veredito
+            unlockCustomer(banker, customerID);
+            __atomic_store_n(&banker->grantVersion, grantVersion + 2, __ATOMIC_RELEASE);
+            engine->hasSafeSequence = 0;
+            worker->conflicts++;
+            STATS_COUNT(commitConflicts);
+            continue;
+        }
+        long rowVersion = applyChange(banker, customerID, request, 1);
+        unlockCustomer(banker, customerID);
+        __atomic_store_n(&banker->grantVersion, grantVersion + 2, __ATOMIC_RELEASE);
+
+        // O snapshot recebe a linha nova se ninguém mais escreveu nela desde a cópia; senão ela é copiada no próximo pedido
+        // Os disponíveis são copiados inteiros em todo snapshot
+        if (rowVersion == worker->rowVersion[customerID])
+        {
+            memcpy(allocationRow(snapshot, customerID), allocation, numberOfResources * sizeof(int));
+            memcpy(needRow(snapshot, customerID), need, numberOfResources * sizeof(int));
+            worker->rowVersion[customerID] = rowVersion + 1;
+            safetyEngineUpdateCustomer(engine, snapshot, customerID);
+        }
+        else
+        {
+            engine->hasSafeSequence = 0;
+        }
+        STATS_DECISION(REQUEST_GRANTED);
+        return REQUEST_GRANTED;
+    }
+}
+
+// Decide uma liberação RL com as mesmas regras de admitRelease. Retorna 1 se foi aplicada
+int concurrentRelease(ConcurrentBanker *banker, int customerID, const int *release, long *order)
+{
+    if (!rowHasNegative(release, banker->state->numberOfResources))
+    {
+        return releaseLocked(banker, customerID, release, order);
+    }
+
+    // Valor negativo tira recursos dos disponíveis, como um pedido: é serializada com os commits pela versão dos pedidos
+    int spins = 0;
+    long grantVersion = __atomic_load_n(&banker->grantVersion, __ATOMIC_SEQ_CST);
+    while ((grantVersion & 1)
+           || !__atomic_compare_exchange_n(&banker->grantVersion, &grantVersion, grantVersion + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+    {
+        backOff(&spins);
+        grantVersion = __atomic_load_n(&banker->grantVersion, __ATOMIC_SEQ_CST);
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    int released = releaseLocked(banker, customerID, release, order);
+    __atomic_store_n(&banker->grantVersion, grantVersion + 2, __ATOMIC_RELEASE);
+    return released;
+}
+
+// Confere e aplica a liberação com o lock do cliente
+static int releaseLocked(ConcurrentBanker *banker, int customerID, const int *release, long *order)
+{
+    BankerState *state = banker->state;
+    const int *allocation = allocationRow(state, customerID);
+
+    STATS_COUNT(releases);
+    lockCustomer(banker, customerID);
+    for (int j = 0; j < state->numberOfResources; j++)
+    {
+        if (release[j] > __atomic_load_n(&allocation[j], __ATOMIC_RELAXED))
+        {
+            STATS_COUNT(releasesDenied);
+            takeOrder(banker, order);
+            unlockCustomer(banker, customerID);
+            return 0;
+        }
+    }
+
+    __atomic_fetch_add(&banker->releasesStarted, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    takeOrder(banker, order);
+    applyChange(banker, customerID, release, -1);
+    __atomic_fetch_add(&banker->releasesFinished, 1, __ATOMIC_RELEASE);
+    unlockCustomer(banker, customerID);
+    return 1;
+}
+
+// Atualiza o snapshot do worker até conseguir uma cópia sem escrita no meio: as linhas com versão nova e os disponíveis
+// Uma linha copiada durante uma escrita fica com a versão antiga (a versão é escrita depois dos valores) e é copiada de
+// novo na próxima volta. No fim o motor recebe as linhas copiadas (muitas de uma vez: remontar as ordenações sai mais barato)
+static void takeSnapshot(ConcurrentWorker *worker, long *grantVersion, long *releases, long *order)
+{
+    ConcurrentBanker *banker = worker->banker;
+    const BankerState *state = banker->state;
+    BankerState *snapshot = worker->snapshot;
+    int spins = 0;
+
+    while (1)
+    {
+        long firstVersion = __atomic_load_n(&banker->grantVersion, __ATOMIC_SEQ_CST);
+        if (firstVersion & 1)
+        {
+            backOff(&spins);
+            continue;
+        }
+        long firstFinished = __atomic_load_n(&banker->releasesFinished, __ATOMIC_SEQ_CST);
+
+        for (int i = 0; i < state->numberOfCustomers; i++)
+        {
+            long version = __atomic_load_n(&banker->rowVersion[i], __ATOMIC_ACQUIRE);
+            if (version != worker->rowVersion[i])
+            {
+                copyRow(worker, i, version);
+            }
+        }
+        for (int j = 0; j < state->numberOfResources; j++)
+        {
+            snapshot->availableResources[j] = __atomic_load_n(&state->availableResources[j], __ATOMIC_RELAXED);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        long stamp = __atomic_fetch_add(&banker->orderCounter, 1, __ATOMIC_SEQ_CST);
+        long lastStarted = __atomic_load_n(&banker->releasesStarted, __ATOMIC_SEQ_CST);
+        long lastVersion = __atomic_load_n(&banker->grantVersion, __ATOMIC_SEQ_CST);
+        if (lastStarted == firstFinished && lastVersion == firstVersion)
+        {
+            *grantVersion = firstVersion;
+            *releases = lastStarted;
+            if (order)
+            {
+                *order = stamp;
+            }
+            break;
+        }
+        worker->snapshotRetries++;
+        backOff(&spins);
+    }
+
+    if (worker->changedCount > state->numberOfCustomers / 8)
+    {
+        rebuildSafetyEngine(worker->engine, snapshot);
+    }
+    else
+    {
+        safetyEngineUpdateCustomers(worker->engine, snapshot, worker->changedRows, worker->changedCount);
+    }
+    for (int c = 0; c < worker->changedCount; c++)
+    {
+        worker->rowChanged[worker->changedRows[c]] = 0;
+    }
+    worker->changedCount = 0;
+}
+
+// Copia a linha do cliente para o snapshot e a guarda para o motor
+// Se alguma alocação aumentou (um pedido de outra thread), a sequência guardada pelo motor pode não valer mais
+static void copyRow(ConcurrentWorker *worker, int customerID, long version)
+{
+    const BankerState *state = worker->banker->state;
+    const int *allocation = allocationRow(state, customerID);
+    const int *need = needRow(state, customerID);
+    int *snapshotAllocation = allocationRow(worker->snapshot, customerID);
+    int *snapshotNeed = needRow(worker->snapshot, customerID);
+
+    for (int j = 0; j < state->numberOfResources; j++)
+    {
+        int value = __atomic_load_n(&allocation[j], __ATOMIC_RELAXED);
+        if (value > snapshotAllocation[j])
+        {
+            worker->engine->hasSafeSequence = 0;
+        }
+        snapshotAllocation[j] = value;
+        snapshotNeed[j] = __atomic_load_n(&need[j], __ATOMIC_RELAXED);
+    }
+    worker->rowVersion[customerID] = version;
+    if (!worker->rowChanged[customerID])
+    {
+        worker->rowChanged[customerID] = 1;
+        worker->changedRows[worker->changedCount++] = customerID;
+    }
+}
+
+// Aplica um pedido (sign = 1) ou uma liberação (sign = -1) no estado compartilhado, com o lock do cliente
+// Retorna a versão da linha antes da escrita (a nova, uma a mais, é publicada depois dos valores)
+static long applyChange(ConcurrentBanker *banker, int customerID, const int *values, int sign)
+{
+    BankerState *state = banker->state;
+    int *allocation = allocationRow(state, customerID);
+    int *need = needRow(state, customerID);
+    long version = __atomic_load_n(&banker->rowVersion[customerID], __ATOMIC_RELAXED);
+
+    for (int j = 0; j < state->numberOfResources; j++)
+    {
+        int delta = sign * values[j];
+        __atomic_store_n(&allocation[j], __atomic_load_n(&allocation[j], __ATOMIC_RELAXED) + delta, __ATOMIC_RELAXED);
+        __atomic_store_n(&need[j], __atomic_load_n(&need[j], __ATOMIC_RELAXED) - delta, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&state->availableResources[j], delta, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&banker->rowVersion[customerID], version + 1, __ATOMIC_RELEASE);
+    return version;
+}
+
+static long takeOrder(ConcurrentBanker *banker, long *order)
+{
+    long stamp = __atomic_fetch_add(&banker->orderCounter, 1, __ATOMIC_SEQ_CST);
+    if (order)
+    {
+        *order = stamp;
+    }
+    return stamp;
+}
+
+static void lockCustomer(ConcurrentBanker *banker, int customerID)
+{
+    int *lock = &banker->customerLock[customerID];
+    int spins = 0;
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE))
+    {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED))
+        {
+            backOff(&spins);
+        }
+    }
+}
+
+static void unlockCustomer(ConcurrentBanker *banker, int customerID)
+{
+    __atomic_store_n(&banker->customerLock[customerID], 0, __ATOMIC_RELEASE);
+}
+
+// Espera ativa curta; depois de algumas voltas cede a CPU (quem está escrevendo pode estar sem CPU)
+static void backOff(int *spins)
+{
+    if (++(*spins) < 64)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    else
+    {
+        sched_yield();
+    }
+}
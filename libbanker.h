@@ -0,0 +1,51 @@
+#ifndef LIBBANKER_H
+#define LIBBANKER_H
+
+#include <stddef.h>
+
+// libbanker (libbanker.a e libbanker.so): o Banker's Algorithm para ser embutido em outro programa
+// Cada Banker é um handle opaco com o estado (demanda máxima, alocação, NEED e disponíveis) e o motor incremental de
+// segurança, num único bloco de memória. Handles diferentes não dividem nada e podem ser usados ao mesmo tempo por threads
+// diferentes; um mesmo handle é usado por uma thread de cada vez. Nada é escrito em arquivos ou na saída
+
+// Só as funções daqui são exportadas pela libbanker.so (o resto é compilado com -fvisibility=hidden)
+#define BANKER_API __attribute__((visibility("default")))
+
+typedef struct Banker Banker;
+
+// Resultado de um pedido ou de uma liberação (os mesmos valores do status de resposta do --serve)
+typedef enum
+{
+    BANKER_GRANTED,            // RQ aceito ou RL aplicado
+    BANKER_EXCEEDS_NEED,       // RQ negado: maior que a NEED do cliente
+    BANKER_NOT_AVAILABLE,      // RQ negado: maior que os recursos disponíveis
+    BANKER_UNSAFE,             // RQ negado: levaria a um estado inseguro
+    BANKER_EXCEEDS_ALLOCATION, // RL negado: maior que a alocação atual do cliente
+    BANKER_INVALID_CUSTOMER    // Cliente fora do intervalo
+} BankerStatus;
+
+typedef struct
+{
+    BankerStatus status;  // Fora BANKER_GRANTED, o estado não mudou
+    int customerID;
+    const int *available; // Recursos disponíveis depois da decisão (dentro do handle, válido até a próxima chamada nele)
+} BankerDecision;
+
+// Declaração das Funções
+BANKER_API size_t bankerMemorySize(int numberOfCustomers, int numberOfResources);
+// bankerCreate e bankerCreateIn retornam NULL se numberOfCustomers ou numberOfResources não é positivo, maximumDemand ou
+// available é NULL, ou algum valor deles é negativo; bankerCreateIn também se memory é NULL, desalinhado ou pequeno demais
+BANKER_API Banker* bankerCreate(int numberOfCustomers, int numberOfResources, const int *maximumDemand, const int *available);
+BANKER_API Banker* bankerCreateIn(void *memory, size_t size, int numberOfCustomers, int numberOfResources, const int *maximumDemand, const int *available);
+BANKER_API void bankerDestroy(Banker *banker);
+BANKER_API BankerDecision bankerRequest(Banker *banker, int customerID, const int *request);
+BANKER_API BankerDecision bankerRelease(Banker *banker, int customerID, const int *release);
+BANKER_API int bankerMaxGrantable(Banker *banker, int customerID, const int *direction, int *grantable);
+BANKER_API int bankerNumberOfCustomers(const Banker *banker);
+BANKER_API int bankerNumberOfResources(const Banker *banker);
+BANKER_API const int* bankerAvailable(const Banker *banker);
+BANKER_API int bankerGetCustomer(const Banker *banker, int customerID, int *maximum, int *allocation, int *need);
+BANKER_API int bankerSaveCheckpoint(const Banker *banker, const char *filename, unsigned long long sequence);
+BANKER_API Banker* bankerLoadCheckpoint(const char *filename, unsigned long long *sequence, const char **error);
+
+#endif
@@ -0,0 +1,287 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+// Handle da libbanker (libbanker.h) sobre o estado, o motor incremental e o pool da checagem paralela
+// bankerCreate e bankerCreateIn montam o Banker, o estado e o motor num bloco só (uma arena, ver BankerArena): criar e
+// destruir um handle é uma alocação e um free (nenhum em bankerCreateIn), e milhares de partições ficam residentes sem
+// fragmentar o heap. A linha de comando usa adoptBankerState com o estado lido de customer.txt ou do checkpoint
+
+struct Banker
+{
+    BankerState *state;
+    SafetyEngine *engine;
+    ThreadPool *pool;         // Checagem paralela (--threads N), NULL no modo serial
+    BankerState *ownedState;  // Estado fora do bloco (adoptBankerState), liberado junto com o handle
+    int ownsBlock;            // 1 se o bloco veio de allocateArenaBlock (bankerDestroy faz o free)
+};
+
+// Os status de RQ são os valores de RequestDecision, convertidos sem tabela
+_Static_assert(BANKER_GRANTED == (int)REQUEST_GRANTED && BANKER_EXCEEDS_NEED == (int)REQUEST_EXCEEDS_NEED
+               && BANKER_NOT_AVAILABLE == (int)REQUEST_NOT_AVAILABLE && BANKER_UNSAFE == (int)REQUEST_UNSAFE,
+               "BankerStatus must extend RequestDecision");
+
+static Banker* arenaBanker(BankerArena *arena, int numberOfCustomers, int numberOfResources, int withState);
+static int validCreateArguments(int numberOfCustomers, int numberOfResources, const int *maximumDemand, const int *available);
+
+// Bytes do bloco de um handle (para bankerCreateIn): o Banker, o estado com padding e o motor incremental
+size_t bankerMemorySize(int numberOfCustomers, int numberOfResources)
+{
+    BankerArena measure = { NULL, 0, 0 };
+    arenaBanker(&measure, numberOfCustomers, numberOfResources, 1);
+    return measure.used;
+}
+
+// Cria um handle com a demanda máxima (numberOfCustomers x numberOfResources, linha a linha, sem padding), alocação zero
+// e os recursos disponíveis. Retorna NULL se os tamanhos não são positivos, maximumDemand ou available é NULL, algum
+// valor é negativo ou falta memória
+Banker* bankerCreate(int numberOfCustomers, int numberOfResources, const int *maximumDemand, const int *available)
+{
+    if (!validCreateArguments(numberOfCustomers, numberOfResources, maximumDemand, available))
+    {
+        return NULL;
+    }
+
+    size_t size = bankerMemorySize(numberOfCustomers, numberOfResources);
+    void *memory = allocateArenaBlock(size);
+    Banker *banker = memory ? bankerCreateIn(memory, size, numberOfCustomers, numberOfResources, maximumDemand, available) : NULL;
+    if (!banker)
+    {
+        free(memory);
+        return NULL;
+    }
+    banker->ownsBlock = 1;
+    return banker;
+}
+
+// Como bankerCreate, dentro de memory (size >= bankerMemorySize, alinhado em 64 bytes), sem alocar nada
+// bankerDestroy não libera memory, que pode receber outro handle depois. Retorna NULL nos mesmos casos de bankerCreate,
+// ou se memory é NULL, não está alinhado ou é menor que bankerMemorySize
+Banker* bankerCreateIn(void *memory, size_t size, int numberOfCustomers, int numberOfResources, const int *maximumDemand, const int *available)
+{
+    if (!memory || (uintptr_t)memory % BANKER_ROW_ALIGNMENT != 0
+        || !validCreateArguments(numberOfCustomers, numberOfResources, maximumDemand, available))
+    {
+        return NULL;
+    }
+
+    BankerArena arena = { (char *)memory, size, 0 };
+    Banker *banker = arenaBanker(&arena, numberOfCustomers, numberOfResources, 1);
+    if (!banker)
+    {
+        return NULL;
+    }
+
+    BankerState *state = banker->state;
+    size_t rowBytes = numberOfResources * sizeof(int);
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        memcpy(maximumRow(state, i), maximumDemand + (size_t)i * numberOfResources, rowBytes);
+        memcpy(needRow(state, i), maximumDemand + (size_t)i * numberOfResources, rowBytes); // A alocação inicial é zero
+    }
+    memcpy(state->availableResources, available, rowBytes);
+    rebuildSafetyEngine(banker->engine, state);
+    return banker;
+}
+
+// Handle sobre um estado já montado (createBankerState, loadCustomerFile ou loadCheckpoint), que passa a ser dele
+// Com numberOfThreads > 1 o motor incremental repara a sequência segura com um pool de threads (ver runEngineCheck)
+// Retorna NULL se falta memória (o estado continua de quem chamou)
+Banker* adoptBankerState(BankerState *state, int numberOfThreads)
+{
+    BankerArena measure = { NULL, 0, 0 };
+    arenaBanker(&measure, state->numberOfCustomers, state->numberOfResources, 0);
+    BankerArena arena = { (char *)allocateArenaBlock(measure.used), measure.used, 0 };
+    if (!arena.base)
+    {
+        return NULL;
+    }
+
+    Banker *banker = arenaBanker(&arena, state->numberOfCustomers, state->numberOfResources, 0);
+    banker->state = state;
+    banker->ownsBlock = 1;
+    rebuildSafetyEngine(banker->engine, state); // Montado a partir da necessidade restante do estado
+    if (numberOfThreads > 1)
+    {
+        banker->pool = createThreadPool(numberOfThreads);
+        if (!banker->pool)
+        {
+            free(banker);
+            return NULL;
+        }
+        banker->engine->pool = banker->pool;
+    }
+    banker->ownedState = state;
+    return banker;
+}
+
+// Libera o handle (o pool, o estado adotado e o bloco de bankerCreate)
+void bankerDestroy(Banker *banker)
+{
+    if (!banker)
+    {
+        return;
+    }
+
+    destroyThreadPool(banker->pool);
+    destroyBankerState(banker->ownedState);
+    if (banker->ownsBlock)
+    {
+        free(banker);
+    }
+}
+
+// Decide um pedido RQ (limites de NEED e de disponíveis, depois a segurança); se aceito, fica aplicado
+BankerDecision bankerRequest(Banker *banker, int customerID, const int *request)
+{
+    BankerState *state = banker->state;
+    BankerDecision decision = { BANKER_INVALID_CUSTOMER, customerID, state->availableResources };
+    if (customerID >= 0 && customerID < state->numberOfCustomers)
+    {
+        decision.status = (BankerStatus)admitRequest(state, banker->engine, customerID, request);
+    }
+    return decision;
+}
+
+// Decide uma liberação RL; negada se passa da alocação atual do cliente
+BankerDecision bankerRelease(Banker *banker, int customerID, const int *release)
+{
+    BankerState *state = banker->state;
+    BankerDecision decision = { BANKER_INVALID_CUSTOMER, customerID, state->availableResources };
+    if (customerID >= 0 && customerID < state->numberOfCustomers)
+    {
+        decision.status = admitRelease(state, banker->engine, customerID, release) ? BANKER_GRANTED : BANKER_EXCEEDS_ALLOCATION;
+    }
+    return decision;
+}
+
+// Maior pedido aceito agora, sem mudar o estado (ver maxGrantableRequest): direction NULL ou só zeros é por recurso
+// customerID -1 responde para todos os clientes (grantable com numberOfCustomers linhas de numberOfResources valores)
+// Retorna 0 se o cliente está fora do intervalo ou a direção tem valor negativo
+int bankerMaxGrantable(Banker *banker, int customerID, const int *direction, int *grantable)
+{
+    BankerState *state = banker->state;
+    if (customerID < -1 || customerID >= state->numberOfCustomers)
+    {
+        return 0;
+    }
+    if (direction && isZeroVector(direction, state->numberOfResources))
+    {
+        direction = NULL;
+    }
+    return customerID < 0 ? maxGrantableAll(state, banker->engine, direction, grantable)
+                          : maxGrantableRequest(state, banker->engine, customerID, direction, grantable);
+}
+
+int bankerNumberOfCustomers(const Banker *banker)
+{
+    return banker->state->numberOfCustomers;
+}
+
+int bankerNumberOfResources(const Banker *banker)
+{
+    return banker->state->numberOfResources;
+}
+
+// Recursos disponíveis (dentro do handle, sem o padding)
+const int* bankerAvailable(const Banker *banker)
+{
+    return banker->state->availableResources;
+}
+
+// Copia as linhas do cliente (qualquer destino NULL é pulado). Retorna 0 se o cliente está fora do intervalo
+int bankerGetCustomer(const Banker *banker, int customerID, int *maximum, int *allocation, int *need)
+{
+    const BankerState *state = banker->state;
+    size_t rowBytes = state->numberOfResources * sizeof(int);
+    if (customerID < 0 || customerID >= state->numberOfCustomers)
+    {
+        return 0;
+    }
+
+    if (maximum)
+    {
+        memcpy(maximum, maximumRow(state, customerID), rowBytes);
+    }
+    if (allocation)
+    {
+        memcpy(allocation, allocationRow(state, customerID), rowBytes);
+    }
+    if (need)
+    {
+        memcpy(need, needRow(state, customerID), rowBytes);
+    }
+    return 1;
+}
+
+// Grava o estado no checkpoint binário (saveCheckpoint), com sequence comandos aplicados
+int bankerSaveCheckpoint(const Banker *banker, const char *filename, unsigned long long sequence)
+{
+    return saveCheckpoint(filename, banker->state, sequence, 0); // Sem result.txt: a saída é de quem usa a biblioteca
+}
+
+// Handle a partir de um checkpoint de bankerSaveCheckpoint (ou de --checkpoint). NULL com o motivo em *error
+Banker* bankerLoadCheckpoint(const char *filename, unsigned long long *sequence, const char **error)
+{
+    BankerState *state = loadCheckpoint(filename, sequence, NULL, error);
+    if (!state)
+    {
+        return NULL;
+    }
+
+    Banker *banker = adoptBankerState(state, 1);
+    if (!banker)
+    {
+        destroyBankerState(state);
+        *error = "unable to allocate the banker";
+    }
+    return banker;
+}
+
+BankerState* getBankerState(const Banker *banker)
+{
+    return banker->state;
+}
+
+SafetyEngine* getBankerEngine(const Banker *banker)
+{
+    return banker->engine;
+}
+
+// Monta o handle dentro da arena: o Banker, o estado (withState) e o motor. NULL se não cabe (ou só mede)
+static Banker* arenaBanker(BankerArena *arena, int numberOfCustomers, int numberOfResources, int withState)
+{
+    Banker *banker = (Banker *)arenaAllocate(arena, sizeof(Banker));
+    BankerState *state = withState ? arenaBankerState(arena, numberOfCustomers, numberOfResources) : NULL;
+    SafetyEngine *engine = arenaSafetyEngine(arena, numberOfCustomers, numberOfResources);
+    if (!banker || (withState && !state) || !engine)
+    {
+        return NULL;
+    }
+
+    banker->state = state;
+    banker->engine = engine;
+    return banker;
+}
+
+// Tamanhos positivos, os dois vetores presentes e nenhum valor negativo (a demanda máxima e os disponíveis)
+static int validCreateArguments(int numberOfCustomers, int numberOfResources, const int *maximumDemand, const int *available)
+{
+    if (numberOfCustomers <= 0 || numberOfResources <= 0 || !maximumDemand || !available)
+    {
+        return 0;
+    }
+    if (rowHasNegative(available, numberOfResources))
+    {
+        return 0;
+    }
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        if (rowHasNegative(maximumDemand + (size_t)i * numberOfResources, numberOfResources))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,441 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "banker.h"
+
+static OutputWriter* createFileWriter(int fileDescriptor);
+static int writeAll(int fileDescriptor, const char *data, size_t length);
+static void growMemoryWriter(OutputWriter *writer, size_t extra);
+static void writeMatrixRow(OutputWriter *filePointer, const int *maximum, const int *allocation, const int *need, int cols);
+
+// Abre (e trunca) o arquivo de saída com um buffer de OUTPUT_BUFFER_SIZE bytes
+OutputWriter* openOutputWriter(const char *filename)
+{
+    int fileDescriptor = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fileDescriptor < 0)
+    {
+        return NULL;
+    }
+    return createFileWriter(fileDescriptor);
+}
+
+// Reabre o arquivo de saída sem truncar, corta em offset bytes e continua escrevendo dali (--restore: o result.txt até o checkpoint)
+// Retorna NULL se o arquivo não abre ou tem menos de offset bytes (a saída até o checkpoint se perdeu)
+OutputWriter* openOutputWriterAt(const char *filename, unsigned long long offset)
+{
+    int fileDescriptor = open(filename, O_WRONLY | O_CREAT, 0644);
+    if (fileDescriptor < 0)
+    {
+        return NULL;
+    }
+
+    struct stat status;
+    if (fstat(fileDescriptor, &status) != 0 || (unsigned long long)status.st_size < offset
+        || ftruncate(fileDescriptor, (off_t)offset) != 0 || lseek(fileDescriptor, (off_t)offset, SEEK_SET) < 0)
+    {
+        close(fileDescriptor);
+        return NULL;
+    }
+    return createFileWriter(fileDescriptor);
+}
+
+// Posição no arquivo em que o próximo byte vai ser escrito (o que já foi para o arquivo mais o buffer)
+unsigned long long outputWriterOffset(const OutputWriter *writer)
+{
+    off_t position = writer->fileDescriptor >= 0 ? lseek(writer->fileDescriptor, 0, SEEK_CUR) : 0;
+    return (unsigned long long)(position > 0 ? position : 0) + writer->length;
+}
+
+// Writer com um buffer de OUTPUT_BUFFER_SIZE bytes sobre um arquivo já aberto (fechado aqui se falta memória)
+static OutputWriter* createFileWriter(int fileDescriptor)
+{
+    OutputWriter *writer = (OutputWriter *)malloc(sizeof(OutputWriter));
+    char *buffer = (char *)malloc(OUTPUT_BUFFER_SIZE);
+    if (!writer || !buffer)
+    {
+        free(writer);
+        free(buffer);
+        close(fileDescriptor);
+        return NULL;
+    }
+
+    writer->fileDescriptor = fileDescriptor;
+    writer->buffer = buffer;
+    writer->capacity = OUTPUT_BUFFER_SIZE;
+    writer->length = 0;
+    writer->failed = 0;
+    return writer;
+}
+
+// Writer em memória (fileDescriptor = -1): nada vai para arquivo, o buffer cresce conforme precisa
+// Quem usa lê buffer[0..length) e zera length quando consumir os dados (ex.: respostas de um cliente do servidor)
+OutputWriter* openMemoryWriter(size_t capacity)
+{
+    if (capacity < 64)
+    {
+        capacity = 64;
+    }
+    OutputWriter *writer = (OutputWriter *)malloc(sizeof(OutputWriter));
+    char *buffer = (char *)malloc(capacity);
+    if (!writer || !buffer)
+    {
+        free(writer);
+        free(buffer);
+        return NULL;
+    }
+
+    writer->fileDescriptor = -1;
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+    writer->length = 0;
+    writer->failed = 0;
+    return writer;
+}
+
+// Descarrega o buffer, fecha o arquivo e libera o writer. Retorna 0 se alguma escrita falhou
+int closeOutputWriter(OutputWriter *writer)
+{
+    if (!writer)
+    {
+        return 0;
+    }
+
+    flushOutputWriter(writer);
+    int ok = !writer->failed;
+    if (writer->fileDescriptor >= 0 && close(writer->fileDescriptor) != 0)
+    {
+        ok = 0;
+    }
+    free(writer->buffer);
+    free(writer);
+    return ok;
+}
+
+// Escreve no arquivo tudo que está no buffer (no writer em memória, só garante espaço livre)
+void flushOutputWriter(OutputWriter *writer)
+{
+    if (writer->fileDescriptor < 0)
+    {
+        growMemoryWriter(writer, writer->capacity);
+        return;
+    }
+    if (writer->length > 0 && !writeAll(writer->fileDescriptor, writer->buffer, writer->length))
+    {
+        writer->failed = 1;
+    }
+    writer->length = 0;
+}
+
+// Copia bytes para o buffer; um bloco maior que o buffer vai direto para o arquivo junto com o buffer (writev)
+void writerPutBytes(OutputWriter *writer, const char *data, size_t length)
+{
+    if (length <= writer->capacity - writer->length)
+    {
+        memcpy(writer->buffer + writer->length, data, length);
+        writer->length += length;
+        return;
+    }
+
+    if (writer->fileDescriptor < 0)
+    {
+        growMemoryWriter(writer, length);
+        if (length <= writer->capacity - writer->length)
+        {
+            memcpy(writer->buffer + writer->length, data, length);
+            writer->length += length;
+        }
+        return;
+    }
+
+    if (length < writer->capacity)
+    {
+        flushOutputWriter(writer);
+        memcpy(writer->buffer, data, length);
+        writer->length = length;
+        return;
+    }
+
+    struct iovec blocks[2] = { { writer->buffer, writer->length }, { (void *)data, length } };
+    size_t total = writer->length + length;
+    ssize_t written;
+    do
+    {
+        written = writev(writer->fileDescriptor, blocks, 2); // Um sinal sem SA_RESTART (SIGUSR1 de --stats) interrompe com EINTR
+    } while (written < 0 && errno == EINTR);
+    if (written < 0)
+    {
+        writer->failed = 1;
+    }
+    else if ((size_t)written < total)
+    {
+        // Escrita parcial: termina o que faltou com write
+        size_t done = (size_t)written;
+        if (done < writer->length)
+        {
+            if (!writeAll(writer->fileDescriptor, writer->buffer + done, writer->length - done))
+            {
+                writer->failed = 1;
+            }
+            done = writer->length;
+        }
+        if (!writeAll(writer->fileDescriptor, data + (done - writer->length), total - done))
+        {
+            writer->failed = 1;
+        }
+    }
+    writer->length = 0;
+}
+
+void writerPutString(OutputWriter *writer, const char *text)
+{
+    writerPutBytes(writer, text, strlen(text));
+}
+
+// Formata um inteiro em decimal direto no buffer (equivalente a "%d")
+void writerPutInt(OutputWriter *writer, int value)
+{
+    if (writer->capacity - writer->length < 12) // "-2147483648" tem 11 caracteres
+    {
+        flushOutputWriter(writer);
+        if (writer->capacity - writer->length < 12)
+        {
+            return; // Writer em memória sem memória para crescer (failed já está marcado)
+        }
+    }
+
+    char digits[12];
+    int count = 0;
+    unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+    do
+    {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+
+    char *out = writer->buffer + writer->length;
+    if (value < 0)
+    {
+        *out++ = '-';
+    }
+    while (count > 0)
+    {
+        *out++ = digits[--count];
+    }
+    writer->length = out - writer->buffer;
+}
+
+// Escreve os valores separados e terminados por espaço (equivalente a "%d " para cada um)
+void writerPutVector(OutputWriter *writer, const int *values, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        writerPutInt(writer, values[i]);
+        if (writer->length < writer->capacity) // writerPutInt sempre deixa pelo menos 1 byte livre, a não ser que tenha falhado
+        {
+            writer->buffer[writer->length++] = ' ';
+        }
+    }
+}
+
+// Imprime as matrizes no arquivo de acordo com o numero de clientes(rows / linhas) e recursos(cols / colunas)
+void printAllMatrices(OutputWriter *filePointer, const BankerState *state) 
+{
+    int rows = state->numberOfCustomers;
+    int cols = state->numberOfResources;
+
+    writerPutString(filePointer, "MAXIMUM | ALLOCATION | NEED\n");
+
+    for (int i = 0; i < rows; i++) 
+    {
+        writeMatrixRow(filePointer, maximumRow(state, i), allocationRow(state, i), needRow(state, i), cols);
+    }
+}
+
+// Imprime a linha de um cliente: MAXIMUM | ALLOCATION | NEED
+static void writeMatrixRow(OutputWriter *filePointer, const int *maximum, const int *allocation, const int *need, int cols)
+{
+    // MAXIMUM
+    for (int j = 0; j < cols; j++) 
+    {
+        writerPutInt(filePointer, maximum[j]);
+        if (j == cols - 1) 
+        {
+            writerPutString(filePointer, "   | ");  // Adiciona três espaços após o último número na coluna MAXIMUM
+        } 
+        else 
+        {
+            writerPutString(filePointer, " ");
+        }
+    }
+
+    // ALLOCATION
+    for (int j = 0; j < cols; j++) 
+    {
+        writerPutInt(filePointer, allocation[j]);
+        if (j == cols - 1) 
+        {
+            writerPutString(filePointer, "      | ");  // Adiciona seis espaços após o último número na coluna ALLOCATION
+        } 
+        else 
+        {
+            writerPutString(filePointer, " ");
+        }
+    }
+
+    // NEED
+    writerPutVector(filePointer, need, cols); // Espaçamento de um espaço após o último número na coluna NEED
+    writerPutString(filePointer, "\n");
+}
+
+// Imprime as matrizes e a linha AVAILABLE (a saída de um comando *)
+void writeStateSnapshot(OutputWriter *writer, const BankerState *state)
+{
+    STATS_COUNT(snapshots);
+    printAllMatrices(writer, state);
+    writerPutString(writer, "AVAILABLE ");
+    writerPutVector(writer, state->availableResources, state->numberOfResources); // Imprime os recursos disponíveis no arquivo
+    writerPutString(writer, "\n");
+}
+
+// Mesma saída de writeStateSnapshot a partir do estado compacto (as linhas são expandidas para int uma de cada vez)
+void writeCompactSnapshot(OutputWriter *writer, const CompactState *state)
+{
+    int cols = state->numberOfResources;
+    int maximum[cols + 1];
+    int allocation[cols + 1];
+    int need[cols + 1];
+
+    STATS_COUNT(snapshots);
+    writerPutString(writer, "MAXIMUM | ALLOCATION | NEED\n");
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        getCompactRow(state, i, maximum, allocation, need);
+        writeMatrixRow(writer, maximum, allocation, need, cols);
+    }
+    getCompactAvailable(state, need);
+    writerPutString(writer, "AVAILABLE ");
+    writerPutVector(writer, need, cols);
+    writerPutString(writer, "\n");
+}
+
+// Escreve a linha de resultado de um pedido RQ
+void writeRequestDecision(OutputWriter *outputFile, RequestDecision decision, int customerID, const int *requestedResources, const int *availableResources, int numberOfResources)
+{
+    switch (decision)
+    {
+    case REQUEST_EXCEEDS_NEED:
+        writerPutString(outputFile, "The customer ");
+        writerPutInt(outputFile, customerID);
+        writerPutString(outputFile, " request ");
+        writerPutVector(outputFile, requestedResources, numberOfResources);
+        writerPutString(outputFile, "was denied because exceed its maximum need\n");
+        break;
+    case REQUEST_NOT_AVAILABLE:
+        writerPutString(outputFile, "The resources ");
+        writerPutVector(outputFile, availableResources, numberOfResources);
+        writerPutString(outputFile, "are not enough to customer ");
+        writerPutInt(outputFile, customerID);
+        writerPutString(outputFile, " request ");
+        writerPutVector(outputFile, requestedResources, numberOfResources);
+        writerPutString(outputFile, "\n");
+        break;
+    case REQUEST_UNSAFE:
+        writerPutString(outputFile, "The customer ");
+        writerPutInt(outputFile, customerID);
+        writerPutString(outputFile, " request ");
+        writerPutVector(outputFile, requestedResources, numberOfResources);
+        writerPutString(outputFile, "was denied because result in an unsafe state\n");
+        break;
+    case REQUEST_GRANTED:
+        writerPutString(outputFile, "Allocate to customer ");
+        writerPutInt(outputFile, customerID);
+        writerPutString(outputFile, " the resources ");
+        writerPutVector(outputFile, requestedResources, numberOfResources);
+        writerPutString(outputFile, "\n");
+        break;
+    }
+}
+
+// Escreve a linha de resultado de uma liberação RL (released: 1 se foi aplicada, 0 se passava da alocação atual)
+void writeReleaseDecision(OutputWriter *outputFile, int released, int customerID, const int *releasedResources, int numberOfResources)
+{
+    if (!released)
+    {
+        writerPutString(outputFile, "The customer ");
+        writerPutInt(outputFile, customerID);
+        writerPutString(outputFile, " released ");
+        writerPutVector(outputFile, releasedResources, numberOfResources);
+        writerPutString(outputFile, "was denied because exceed its maximum allocation\n");
+        return;
+    }
+
+    writerPutString(outputFile, "Release from customer ");
+    writerPutInt(outputFile, customerID);
+    writerPutString(outputFile, " the resources ");
+    writerPutVector(outputFile, releasedResources, numberOfResources);
+    writerPutString(outputFile, "\n");
+}
+
+// Escreve a linha de resultado de uma consulta QM de um cliente (direction NULL: o máximo de cada recurso sozinho)
+void writeGrantableQuery(OutputWriter *outputFile, int customerID, const int *grantable, const int *direction, int numberOfResources)
+{
+    writerPutString(outputFile, "The customer ");
+    writerPutInt(outputFile, customerID);
+    writerPutString(outputFile, " can safely request up to ");
+    writerPutVector(outputFile, grantable, numberOfResources);
+    if (!direction)
+    {
+        writerPutString(outputFile, "of each resource\n");
+        return;
+    }
+    writerPutString(outputFile, "along ");
+    writerPutVector(outputFile, direction, numberOfResources);
+    writerPutString(outputFile, "\n");
+}
+
+// Garante pelo menos extra bytes livres no writer em memória (dobra o buffer até caber)
+static void growMemoryWriter(OutputWriter *writer, size_t extra)
+{
+    size_t capacity = writer->capacity;
+    while (capacity - writer->length < extra)
+    {
+        capacity *= 2;
+    }
+    if (capacity == writer->capacity)
+    {
+        return;
+    }
+
+    char *buffer = (char *)realloc(writer->buffer, capacity);
+    if (!buffer)
+    {
+        writer->failed = 1;
+        return;
+    }
+    writer->buffer = buffer;
+    writer->capacity = capacity;
+}
+
+// write() até escrever tudo, tratando escritas parciais
+static int writeAll(int fileDescriptor, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t written = write(fileDescriptor, data, length);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return 0;
+        }
+        data += written;
+        length -= written;
+    }
+    return 1;
+}
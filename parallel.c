@@ -0,0 +1,353 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+// Área de cada thread: os candidatos que não couberam nesta passada e a soma das alocações dos que couberam
+typedef struct
+{
+    int *remaining;      // Clientes do pedaço que continuam sem terminar
+    int remainingCount;
+    int *allocationSum;  // Soma das alocações dos clientes que terminaram nesta passada
+    int *finished;       // Clientes que terminaram nesta passada, na ordem
+    int finishedCount;   // Número de clientes que terminaram nesta passada
+} WorkerSlot;
+
+typedef struct
+{
+    struct ThreadPool *pool;
+    int index;
+} WorkerArgument;
+
+struct ThreadPool
+{
+    int numberOfThreads;   // Inclui a thread que chama checkSafetyParallel
+    pthread_t *threads;
+    WorkerArgument *arguments;
+    pthread_barrier_t startBarrier;
+    pthread_barrier_t endBarrier;
+    pthread_mutex_t startupLock;  // Segura as threads auxiliares até as barreiras existirem (com o número de threads que subiu)
+    pthread_cond_t startupReady;
+    int started;
+    int stop;
+
+    // Passada atual
+    const BankerState *state;
+    const SafetyOverlay *overlay;
+    const int *work;
+    int *candidates;       // Clientes que ainda não terminaram (alocado com os slots)
+    int candidateCount;
+    WorkerSlot *slots;
+    int capacity;          // Número de clientes para o qual os slots foram alocados
+    int rowStride;
+};
+
+static void scanChunk(ThreadPool *pool, int index);
+static void* workerMain(void *argument);
+static int reserveSlots(ThreadPool *pool, const BankerState *state);
+static int runPasses(ThreadPool *pool, const BankerState *state, const SafetyOverlay *overlay, int *work, int candidateCount, int *sequence, int *passes);
+
+// Cria o pool com numberOfThreads - 1 threads auxiliares (a thread chamadora também trabalha)
+// Se alguma thread não sobe, o pool fica com as que subiram (as barreiras são criadas depois, com esse número)
+ThreadPool* createThreadPool(int numberOfThreads)
+{
+    if (numberOfThreads < 1)
+    {
+        numberOfThreads = 1;
+    }
+
+    ThreadPool *pool = (ThreadPool *)calloc(1, sizeof(ThreadPool));
+    if (!pool)
+    {
+        return NULL;
+    }
+    pool->numberOfThreads = numberOfThreads;
+    pool->threads = (pthread_t *)calloc(numberOfThreads, sizeof(pthread_t));
+    pool->slots = (WorkerSlot *)calloc(numberOfThreads, sizeof(WorkerSlot));
+    pool->arguments = (WorkerArgument *)calloc(numberOfThreads, sizeof(WorkerArgument));
+    if (!pool->threads || !pool->slots || !pool->arguments)
+    {
+        free(pool->arguments);
+        free(pool->threads);
+        free(pool->slots);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->startupLock, NULL);
+    pthread_cond_init(&pool->startupReady, NULL);
+    int running = 1;
+    while (running < numberOfThreads)
+    {
+        pool->arguments[running].pool = pool;
+        pool->arguments[running].index = running;
+        if (pthread_create(&pool->threads[running], NULL, workerMain, &pool->arguments[running]) != 0)
+        {
+            break;
+        }
+        running++;
+    }
+
+    // As threads que subiram só passam a usar as barreiras depois disto
+    pool->numberOfThreads = running;
+    pthread_barrier_init(&pool->startBarrier, NULL, running);
+    pthread_barrier_init(&pool->endBarrier, NULL, running);
+    pthread_mutex_lock(&pool->startupLock);
+    pool->started = 1;
+    pthread_cond_broadcast(&pool->startupReady);
+    pthread_mutex_unlock(&pool->startupLock);
+    return pool;
+}
+
+// Para as threads auxiliares e libera o pool
+void destroyThreadPool(ThreadPool *pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    pool->stop = 1;
+    pthread_barrier_wait(&pool->startBarrier);
+    for (int t = 1; t < pool->numberOfThreads; t++)
+    {
+        pthread_join(pool->threads[t], NULL);
+    }
+    pthread_barrier_destroy(&pool->startBarrier);
+    pthread_barrier_destroy(&pool->endBarrier);
+    pthread_mutex_destroy(&pool->startupLock);
+    pthread_cond_destroy(&pool->startupReady);
+
+    for (int t = 0; t < pool->numberOfThreads; t++)
+    {
+        free(pool->slots[t].remaining);
+        free(pool->slots[t].allocationSum);
+        free(pool->slots[t].finished);
+    }
+    free(pool->slots);
+    free(pool->candidates);
+    free(pool->threads);
+    free(pool->arguments);
+    free(pool);
+}
+
+int threadPoolSize(const ThreadPool *pool)
+{
+    return pool->numberOfThreads;
+}
+
+// Checa se o estado é seguro dividindo cada passada entre as threads do pool
+// Diferente de checkSafety, cada passada termina todos os clientes cuja NEED cabe em work no início da passada
+// (terminar um cliente só aumenta work, então o veredito é o mesmo), e só os clientes que sobraram são varridos de novo
+// Com alguma alocação negativa isso não vale mais: quem chama garante que não há nenhuma (o motor incremental sabe pelo
+// negativeAllocationCount, e nesse caso checa com checkSafety)
+int checkSafetyParallel(ThreadPool *pool, const BankerState *state)
+{
+    SafetyOverlay none = { -1, state->availableResources, NULL, NULL };
+    return checkSafetyParallelOverlay(pool, state, &none);
+}
+
+// Mesma checagem sobre o estado com um pedido hipotético, sem escrever no estado
+int checkSafetyParallelOverlay(ThreadPool *pool, const BankerState *state, const SafetyOverlay *overlay)
+{
+    int numberOfCustomers = state->numberOfCustomers;
+    int rowLength = state->rowStride;
+
+    if (!reserveSlots(pool, state))
+    {
+        return checkSafetyOverlay(state, overlay, NULL); // Sem memória para o modo paralelo, usa o caminho serial
+    }
+
+    int work[rowLength];
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        pool->candidates[i] = i;
+    }
+    memcpy(work, overlay->available, rowLength * sizeof(int));
+
+    int passes = 0;
+    int safe = runPasses(pool, state, overlay, work, numberOfCustomers, NULL, &passes);
+    STATS_PASSES(passes);
+    return safe;
+}
+
+// Termina com as passadas paralelas uma checagem do motor incremental que já percorreu completed clientes
+// work e finished são os do ponto em que o motor parou; os clientes que terminam são acrescentados a sequence,
+// que fica uma sequência segura completa se o estado é seguro. Supõe que nenhuma alocação é negativa
+// Retorna 1 se seguro, 0 se não, e -1 se não há memória para o modo paralelo (quem chama checa de outro jeito)
+int checkSafetyParallelRepair(ThreadPool *pool, const BankerState *state, const SafetyOverlay *overlay, int *work, const int *finished, int *sequence, int completed)
+{
+    int numberOfCustomers = state->numberOfCustomers;
+    if (!reserveSlots(pool, state))
+    {
+        return -1;
+    }
+
+    int candidateCount = 0;
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        if (!finished[i])
+        {
+            pool->candidates[candidateCount++] = i;
+        }
+    }
+
+    int passes = 0;
+    return runPasses(pool, state, overlay, work, candidateCount, sequence + completed, &passes);
+}
+
+// Passadas paralelas sobre os candidatos até todos terminarem (1) ou uma passada não terminar ninguém (0)
+// work cresce com as alocações devolvidas; sequence (se não NULL) recebe os clientes na ordem em que terminaram
+static int runPasses(ThreadPool *pool, const BankerState *state, const SafetyOverlay *overlay, int *work, int candidateCount, int *sequence, int *passes)
+{
+    int *candidates = pool->candidates;
+    const SafetyKernels *kernels = getSafetyKernels();
+    int rowLength = state->rowStride;
+    int safe = 1;
+    int completed = 0;
+    pool->state = state;
+    pool->overlay = overlay;
+    pool->work = work;
+
+    while (candidateCount > 0)
+    {
+        pool->candidateCount = candidateCount;
+        (*passes)++;
+
+        // Cada thread varre o seu pedaço dos candidatos
+        pthread_barrier_wait(&pool->startBarrier);
+        scanChunk(pool, 0);
+        pthread_barrier_wait(&pool->endBarrier);
+
+        // Junta os resultados: soma as alocações devolvidas e compacta os candidatos que sobraram, na ordem
+        int finishedCount = 0;
+        candidateCount = 0;
+        for (int t = 0; t < pool->numberOfThreads; t++)
+        {
+            WorkerSlot *slot = &pool->slots[t];
+            if (slot->finishedCount > 0)
+            {
+                kernels->addToWork(work, slot->allocationSum, rowLength);
+                finishedCount += slot->finishedCount;
+                if (sequence)
+                {
+                    memcpy(sequence + completed, slot->finished, slot->finishedCount * sizeof(int));
+                    completed += slot->finishedCount;
+                }
+            }
+            memmove(candidates + candidateCount, slot->remaining, slot->remainingCount * sizeof(int));
+            candidateCount += slot->remainingCount;
+        }
+
+        // Nenhum cliente terminou nesta passada: work não muda mais, então não é seguro
+        if (finishedCount == 0)
+        {
+            safe = 0;
+            break;
+        }
+    }
+    return safe;
+}
+
+// Varre a fatia dos candidatos que cabe à thread index
+static void scanChunk(ThreadPool *pool, int index)
+{
+    const SafetyKernels *kernels = getSafetyKernels();
+    const BankerState *state = pool->state;
+    const SafetyOverlay *overlay = pool->overlay;
+    WorkerSlot *slot = &pool->slots[index];
+    int rowLength = pool->rowStride;
+    int count = pool->candidateCount;
+    int begin = (int)((long long)count * index / pool->numberOfThreads);
+    int end = (int)((long long)count * (index + 1) / pool->numberOfThreads);
+
+    slot->remainingCount = 0;
+    slot->finishedCount = 0;
+    memset(slot->allocationSum, 0, rowLength * sizeof(int));
+
+    for (int p = begin; p < end; p++)
+    {
+        int i = pool->candidates[p];
+        if (kernels->needFitsWork(overlayNeedRow(state, overlay, i), pool->work, rowLength))
+        {
+            kernels->addToWork(slot->allocationSum, overlayAllocationRow(state, overlay, i), rowLength);
+            slot->finished[slot->finishedCount++] = i;
+        }
+        else
+        {
+            slot->remaining[slot->remainingCount++] = i;
+        }
+    }
+}
+
+// Laço das threads auxiliares: espera uma passada, varre o seu pedaço e avisa que terminou
+static void* workerMain(void *argument)
+{
+    ThreadPool *pool = ((WorkerArgument *)argument)->pool;
+    int index = ((WorkerArgument *)argument)->index;
+
+    pthread_mutex_lock(&pool->startupLock);
+    while (!pool->started)
+    {
+        pthread_cond_wait(&pool->startupReady, &pool->startupLock);
+    }
+    pthread_mutex_unlock(&pool->startupLock);
+
+    while (1)
+    {
+        pthread_barrier_wait(&pool->startBarrier);
+        if (pool->stop)
+        {
+            break;
+        }
+        scanChunk(pool, index);
+        pthread_barrier_wait(&pool->endBarrier);
+    }
+    return NULL;
+}
+
+// Garante que os slots e a lista de candidatos comportam o estado (cada thread pode receber até todos os clientes)
+static int reserveSlots(ThreadPool *pool, const BankerState *state)
+{
+    if (pool->capacity >= state->numberOfCustomers && pool->rowStride == state->rowStride)
+    {
+        return 1;
+    }
+
+    int *candidates = (int *)realloc(pool->candidates, (state->numberOfCustomers + 1) * sizeof(int));
+    if (!candidates)
+    {
+        pool->capacity = 0;
+        return 0;
+    }
+    pool->candidates = candidates;
+
+    for (int t = 0; t < pool->numberOfThreads; t++)
+    {
+        WorkerSlot *slot = &pool->slots[t];
+        int *remaining = (int *)realloc(slot->remaining, (state->numberOfCustomers + 1) * sizeof(int));
+        int *allocationSum = (int *)realloc(slot->allocationSum, state->rowStride * sizeof(int));
+        int *finished = (int *)realloc(slot->finished, (state->numberOfCustomers + 1) * sizeof(int));
+        if (remaining)
+        {
+            slot->remaining = remaining;
+        }
+        if (allocationSum)
+        {
+            slot->allocationSum = allocationSum;
+        }
+        if (finished)
+        {
+            slot->finished = finished;
+        }
+        if (!remaining || !allocationSum || !finished)
+        {
+            pool->capacity = 0;
+            return 0;
+        }
+        slot->remainingCount = 0;
+    }
+    pool->capacity = state->numberOfCustomers;
+    pool->rowStride = state->rowStride;
+    return 1;
+}
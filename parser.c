@@ -0,0 +1,407 @@
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "banker.h"
+
+static int parseInt(const char **cursor, const char *end, int *value);
+static void skipBlanks(const char **cursor, const char *end);
+static int failLine(CommandParser *parser, const char *message);
+static int parseQuery(CommandParser *parser, const char *cursor, const char *lineEnd, Command *command);
+
+// Mapeia o arquivo inteiro na memória (somente leitura). Um arquivo vazio fica com data = NULL e size = 0
+int mapFile(const char *filename, MappedFile *file)
+{
+    file->data = NULL;
+    file->size = 0;
+
+    int fileDescriptor = open(filename, O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+        return 0;
+    }
+
+    struct stat info;
+    if (fstat(fileDescriptor, &info) != 0)
+    {
+        close(fileDescriptor);
+        return 0;
+    }
+
+    if (info.st_size > 0)
+    {
+        void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fileDescriptor);
+            return 0;
+        }
+        madvise(data, info.st_size, MADV_SEQUENTIAL); // Lido uma vez do início ao fim
+        file->data = (const char *)data;
+        file->size = info.st_size;
+    }
+
+    close(fileDescriptor); // O mapeamento continua válido depois do close
+    return 1;
+}
+
+void unmapFile(MappedFile *file)
+{
+    if (file->data)
+    {
+        munmap((void *)file->data, file->size);
+    }
+    file->data = NULL;
+    file->size = 0;
+}
+
+// Prepara o parser para ler os comandos de data[0..size)
+// resources é o vetor (de numberOfResources posições) onde cada comando RQ/RL deixa os seus valores
+void initCommandParser(CommandParser *parser, const char *data, size_t size, int numberOfCustomers, int numberOfResources, int *resources)
+{
+    parser->cursor = data;
+    parser->end = data + size;
+    parser->lineNumber = 0;
+    parser->numberOfCustomers = numberOfCustomers;
+    parser->numberOfResources = numberOfResources;
+    parser->resources = resources;
+    parser->error = NULL;
+}
+
+// Lê a próxima linha de comando numa única passada, sem alocar memória
+// Retorna 1 e preenche command, 0 no fim do arquivo, ou -1 se a linha estiver mal formada (parser->error e parser->lineNumber dizem o porquê e onde)
+int nextCommand(CommandParser *parser, Command *command)
+{
+    const char *cursor = parser->cursor;
+    const char *end = parser->end;
+
+    if (cursor >= end)
+    {
+        return 0;
+    }
+
+    // Acha o fim da linha (o '\n' não faz parte dela)
+    const char *lineEnd = (const char *)memchr(cursor, '\n', end - cursor);
+    if (!lineEnd)
+    {
+        lineEnd = end;
+    }
+    parser->lineNumber++;
+    parser->cursor = lineEnd < end ? lineEnd + 1 : end;
+
+    // Uma linha que é só "*" imprime as matrizes
+    if (lineEnd - cursor == 1 && *cursor == '*')
+    {
+        command->type = COMMAND_PRINT;
+        command->customerID = -1;
+        command->resources = NULL;
+        return 1;
+    }
+
+    // CP grava um checkpoint
+    skipBlanks(&cursor, lineEnd);
+    if (lineEnd - cursor >= 2 && cursor[0] == 'C' && cursor[1] == 'P')
+    {
+        const char *rest = cursor + 2;
+        skipBlanks(&rest, lineEnd);
+        if (rest == lineEnd)
+        {
+            command->type = COMMAND_CHECKPOINT;
+            command->customerID = -1;
+            command->resources = NULL;
+            return 1;
+        }
+    }
+
+    // QM: consulta do maior pedido aceito
+    if (lineEnd - cursor >= 2 && cursor[0] == 'Q' && cursor[1] == 'M')
+    {
+        return parseQuery(parser, cursor + 2, lineEnd, command);
+    }
+
+    // Comando: RQ ou RL
+    if (lineEnd - cursor < 2 || cursor[0] != 'R' || (cursor[1] != 'Q' && cursor[1] != 'L'))
+    {
+        return failLine(parser, "expected RQ, RL, QM, * or CP");
+    }
+    command->type = cursor[1] == 'Q' ? COMMAND_REQUEST : COMMAND_RELEASE;
+    cursor += 2;
+    if (cursor < lineEnd && *cursor != ' ' && *cursor != '\t' && *cursor != '\r')
+    {
+        return failLine(parser, "expected RQ, RL, QM, * or CP");
+    }
+
+    // ID do cliente
+    if (!parseInt(&cursor, lineEnd, &command->customerID))
+    {
+        return failLine(parser, "invalid customer number");
+    }
+    if (command->customerID < 0 || command->customerID >= parser->numberOfCustomers)
+    {
+        return failLine(parser, "customer number out of range");
+    }
+
+    // Um valor por recurso
+    for (int i = 0; i < parser->numberOfResources; i++)
+    {
+        if (!parseInt(&cursor, lineEnd, &parser->resources[i]))
+        {
+            return failLine(parser, "expected one integer per resource");
+        }
+    }
+    skipBlanks(&cursor, lineEnd);
+    if (cursor != lineEnd)
+    {
+        return failLine(parser, "more values than resources");
+    }
+
+    command->resources = parser->resources;
+    return 1;
+}
+
+// Resto de uma linha QM: "QM <cliente ou *> [direção]". Sem a direção (ou com ela toda zero) a consulta é por recurso
+// A direção ausente fica como zeros no vetor do parser, então command->resources nunca é NULL num QM
+static int parseQuery(CommandParser *parser, const char *cursor, const char *lineEnd, Command *command)
+{
+    command->type = COMMAND_QUERY;
+    if (cursor < lineEnd && *cursor != ' ' && *cursor != '\t' && *cursor != '\r')
+    {
+        return failLine(parser, "expected RQ, RL, QM, * or CP");
+    }
+
+    skipBlanks(&cursor, lineEnd);
+    if (cursor < lineEnd && *cursor == '*' && (cursor + 1 == lineEnd || cursor[1] == ' ' || cursor[1] == '\t' || cursor[1] == '\r'))
+    {
+        command->customerID = -1; // Todos os clientes
+        cursor++;
+    }
+    else if (!parseInt(&cursor, lineEnd, &command->customerID))
+    {
+        return failLine(parser, "invalid customer number");
+    }
+    else if (command->customerID < 0 || command->customerID >= parser->numberOfCustomers)
+    {
+        return failLine(parser, "customer number out of range");
+    }
+
+    skipBlanks(&cursor, lineEnd);
+    if (cursor == lineEnd)
+    {
+        memset(parser->resources, 0, parser->numberOfResources * sizeof(int));
+    }
+    else
+    {
+        for (int i = 0; i < parser->numberOfResources; i++)
+        {
+            if (!parseInt(&cursor, lineEnd, &parser->resources[i]))
+            {
+                return failLine(parser, "expected one integer per resource");
+            }
+        }
+    }
+    skipBlanks(&cursor, lineEnd);
+    if (cursor != lineEnd)
+    {
+        return failLine(parser, "more values than resources");
+    }
+
+    command->resources = parser->resources;
+    return 1;
+}
+
+// Lê a próxima linha de customer.txt: numberOfResources valores separados por vírgula, com as regras de fgets + strtok + atoi
+// (vírgulas seguidas contam como uma, o '\n' faz parte do último campo e cada valor é o número no início do campo)
+// Valores a mais na linha são ignorados. Retorna 1 e avança *cursor para a linha seguinte, ou 0 se faltam valores
+int parseCustomerRow(const char **cursor, const char *end, int *values, int numberOfResources)
+{
+    const char *p = *cursor;
+    const char *lineEnd = (const char *)memchr(p, '\n', end - p);
+    const char *limit = lineEnd ? lineEnd + 1 : end;
+
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        while (p < limit && *p == ',')
+        {
+            p++;
+        }
+        if (p >= limit)
+        {
+            return 0;
+        }
+
+        // atoi: brancos, sinal e dígitos
+        while (p < limit && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' || *p == '\v' || *p == '\f'))
+        {
+            p++;
+        }
+        int negative = p < limit && *p == '-';
+        if (p < limit && (*p == '-' || *p == '+'))
+        {
+            p++;
+        }
+        unsigned long number = 0; // Como o strtol do atoi: satura em LONG_MAX / LONG_MIN e o valor é truncado para int
+        while (p < limit && *p >= '0' && *p <= '9')
+        {
+            number = number > (unsigned long)LONG_MAX / 10 ? (unsigned long)LONG_MAX + 1 : number * 10 + (*p - '0');
+            p++;
+        }
+        if (number > (unsigned long)LONG_MAX)
+        {
+            number = (unsigned long)LONG_MAX + negative;
+        }
+        values[j] = (int)(negative ? -number : number);
+
+        while (p < limit && *p != ',')
+        {
+            p++;
+        }
+    }
+
+    *cursor = limit;
+    return 1;
+}
+
+// Dimensões de customer.txt já mapeado, contadas como no getline/strtok do caminho antigo: o número de linhas (a última
+// pode não ter '\n') e o número de campos separados por vírgula na primeira linha (-1 num arquivo vazio)
+void measureCustomerFile(const char *data, size_t size, int *numberOfCustomers, int *numberOfResources)
+{
+    const char *end = data + size;
+    const char *firstLineEnd = NULL;
+    int lines = 0;
+
+    for (const char *p = data; p < end; lines++)
+    {
+        const char *lineEnd = (const char *)memchr(p, '\n', end - p);
+        p = lineEnd ? lineEnd + 1 : end;
+        if (!firstLineEnd)
+        {
+            firstLineEnd = p;
+        }
+    }
+
+    int fields = size > 0 ? 0 : -1;
+    for (const char *p = data; p < firstLineEnd; p++)
+    {
+        fields += *p != ',' && (p == data || p[-1] == ',');
+    }
+    *numberOfCustomers = lines;
+    *numberOfResources = fields;
+}
+
+// Lê customer.txt numa passada: o arquivo é mapeado uma vez, as linhas são contadas (memchr) para alocar o estado e cada
+// linha é convertida direto para a matriz de demanda máxima, já com a NEED. As linhas podem ter qualquer largura
+// Retorna NULL (com o motivo em *status) se o arquivo não abre, não tem numberOfResources colunas ou tem linha incompleta
+BankerState* loadCustomerFile(const char *filename, int numberOfResources, CustomerFileStatus *status)
+{
+    MappedFile file;
+    if (!mapFile(filename, &file))
+    {
+        *status = CUSTOMERS_UNREADABLE;
+        return NULL;
+    }
+
+    int numberOfCustomers;
+    int fileNumberOfResources;
+    measureCustomerFile(file.data, file.size, &numberOfCustomers, &fileNumberOfResources);
+    if (fileNumberOfResources != numberOfResources)
+    {
+        unmapFile(&file);
+        *status = CUSTOMERS_WIDTH_MISMATCH;
+        return NULL;
+    }
+
+    BankerState *state = createBankerState(numberOfCustomers, numberOfResources);
+    if (!state)
+    {
+        unmapFile(&file);
+        *status = CUSTOMERS_NO_MEMORY;
+        return NULL;
+    }
+
+    const char *cursor = file.data;
+    const char *end = file.data + file.size;
+    *status = CUSTOMERS_LOADED;
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        int *maximum = maximumRow(state, i);
+        if (!parseCustomerRow(&cursor, end, maximum, numberOfResources))
+        {
+            *status = CUSTOMERS_MALFORMED;
+            break;
+        }
+        memcpy(needRow(state, i), maximum, numberOfResources * sizeof(int)); // NEED = máximo, a alocação começa zerada
+    }
+
+    unmapFile(&file);
+    if (*status != CUSTOMERS_LOADED)
+    {
+        destroyBankerState(state);
+        return NULL;
+    }
+    return state;
+}
+
+// Marca a linha como mal formada
+static int failLine(CommandParser *parser, const char *message)
+{
+    parser->error = message;
+    return -1;
+}
+
+// Pula espaços, tabs e o '\r' de arquivos com fim de linha CRLF
+static void skipBlanks(const char **cursor, const char *end)
+{
+    const char *p = *cursor;
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    {
+        p++;
+    }
+    *cursor = p;
+}
+
+// Lê um inteiro com sinal opcional depois dos brancos; o número tem que terminar num branco ou no fim da linha
+static int parseInt(const char **cursor, const char *end, int *value)
+{
+    skipBlanks(cursor, end);
+    const char *p = *cursor;
+    int negative = 0;
+
+    if (p < end && (*p == '-' || *p == '+'))
+    {
+        negative = *p == '-';
+        p++;
+    }
+    if (p >= end || *p < '0' || *p > '9')
+    {
+        return 0;
+    }
+
+    long long number = 0;
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        number = number * 10 + (*p - '0');
+        if (number > (long long)INT_MAX + 1)
+        {
+            return 0; // Não cabe num int
+        }
+        p++;
+    }
+    if (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+    {
+        return 0;
+    }
+    if (negative)
+    {
+        number = -number;
+    }
+    if (number > INT_MAX)
+    {
+        return 0;
+    }
+
+    *value = (int)number;
+    *cursor = p;
+    return 1;
+}
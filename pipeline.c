@@ -0,0 +1,577 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "banker.h"
+
+// Execução de commands.txt (ou do trace binário) em três threads ligadas por filas SPSC limitadas:
+//   leitura (parser ou trace) -> decisão (uma thread só, na ordem do arquivo) -> escrita de result.txt
+// A decisão é a mesma do modo serial (admitRequest/admitRelease sobre o mesmo estado), e a thread de escrita formata as
+// linhas com as mesmas funções, então result.txt sai idêntico. Um * copia o estado para a fila de snapshots (um slot só),
+// e a thread de escrita formata a cópia enquanto a decisão continua. Um QM de todos os clientes usa o mesmo slot.
+//
+// Cada fila tem um produtor e um consumidor: os índices são escritos só pelo seu dono e lidos pelo outro lado com
+// acquire/release. Quem acha a fila vazia (ou cheia) espera um pouco girando e depois dorme numa variável de condição;
+// o outro lado só pega o mutex para acordar quem marcou que está dormindo, e só quando há wakeBatch slots prontos (ou
+// livres), para cada troca de thread render um bloco de comandos. Antes de dormir, uma thread acorda quem estiver
+// esperando em qualquer fila do pipeline, então ninguém fica esperando um bloco que não vai se completar.
+
+#define CACHE_LINE 64
+#define PIPELINE_END -1       // Slot que termina a fila (fim do arquivo ou erro)
+#define PIPELINE_SNAPSHOT -2  // Slot da fila de saída: o estado do * está na fila de snapshots
+
+typedef struct SpscRing
+{
+    unsigned long head __attribute__((aligned(CACHE_LINE))); // Slots já consumidos (só o consumidor escreve)
+    unsigned long cachedTail; // Última tail vista pelo consumidor
+    int consumerWaiting;      // 1 enquanto o consumidor dorme esperando dados
+    unsigned long tail __attribute__((aligned(CACHE_LINE))); // Slots já publicados (só o produtor escreve)
+    unsigned long cachedHead; // Último head visto pelo produtor
+    int producerWaiting;      // 1 enquanto o produtor dorme esperando espaço
+    int closed __attribute__((aligned(CACHE_LINE))); // O consumidor parou: o produtor não deve mais publicar
+    unsigned long slotCount;  // Potência de 2
+    unsigned long wakeBatch;  // Slots prontos (ou livres) para acordar o outro lado
+    size_t slotSize;
+    char *slots;
+    pthread_mutex_t lock;
+    pthread_cond_t wakeUp;
+    struct SpscRing **group;  // Filas do mesmo pipeline (acordadas antes de dormir)
+    int groupSize;
+} SpscRing;
+
+// Slot das filas de comandos e de saída
+typedef struct
+{
+    int kind;           // CommandType do comando, PIPELINE_END ou PIPELINE_SNAPSHOT
+    int customerID;
+    int decision;       // Na fila de saída: o RequestDecision do RQ, 1/0 (aplicada/negada) do RL ou 1 no QM por recurso
+    long position;      // Linha de commands.txt ou registro do trace (para a mensagem de erro)
+    const char *error;  // Em PIPELINE_END: o motivo da parada (NULL no fim do arquivo)
+    int values[];       // Valores do comando; na fila de saída, seguidos dos disponíveis vistos pelo RQ (ou da direção do QM)
+} PipelineSlot;
+
+typedef struct
+{
+    // Leitura
+    int binaryTrace;
+    CommandParser parser;
+    BinaryTrace trace;
+    int numberOfCustomers;
+    int numberOfResources;
+
+    // Decisão
+    BankerState *state;
+    SafetyEngine *engine;
+    const char *error;  // Motivo da parada, NULL se o arquivo foi até o fim
+    long position;
+
+    // Escrita
+    OutputWriter *writer;
+
+    SpscRing *commands;  // Leitura -> decisão
+    SpscRing *decisions; // Decisão -> escrita
+    SpscRing *snapshots; // Cópias do estado dos comandos * (e resultados de QM *), decisão -> escrita
+    SpscRing *rings[3];
+} Pipeline;
+
+static int ringSpins; // Voltas girando antes de dormir (0 com uma CPU só, onde girar só atrasa o outro lado)
+
+static SpscRing* createRing(unsigned long slotCount, unsigned long wakeBatch, size_t slotSize);
+static void destroyRing(SpscRing *ring);
+static void* ringReserve(SpscRing *ring);
+static void ringPublish(SpscRing *ring);
+static void ringFinish(SpscRing *ring);
+static void* ringFront(SpscRing *ring);
+static void ringRelease(SpscRing *ring);
+static void closeRing(SpscRing *ring);
+static void waitRing(SpscRing *ring, const unsigned long *index, unsigned long stale, int *waiting);
+static void wakeRing(SpscRing *ring, const int *waiting, unsigned long ready);
+static void wakeGroup(SpscRing *ring);
+static void* readStage(void *argument);
+static void decideStage(Pipeline *pipeline);
+static int decideQuery(Pipeline *pipeline, const PipelineSlot *command, PipelineSlot *output);
+static void* writeStage(void *argument);
+static size_t snapshotBytes(const BankerState *state);
+
+// Executa os comandos de filename (binaryTrace: um trace de --convert-trace) sobre o estado, escrevendo em writer
+// O estado e o motor (com o pool dele) são usados só pela thread que chama (a decisão); writer, só pela thread de escrita
+// Retorna 0 se o arquivo não abre ou um comando é inválido (a mensagem é a mesma do modo serial)
+int runCommandPipeline(const char *filename, int binaryTrace, BankerState *state, SafetyEngine *engine, OutputWriter *writer)
+{
+    Pipeline pipeline;
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.binaryTrace = binaryTrace;
+    pipeline.numberOfCustomers = state->numberOfCustomers;
+    pipeline.numberOfResources = state->numberOfResources;
+    pipeline.state = state;
+    pipeline.engine = engine;
+    pipeline.writer = writer;
+
+    MappedFile file = { NULL, 0 };
+    if (binaryTrace)
+    {
+        if (!openBinaryTrace(filename, &pipeline.trace))
+        {
+            printf("%s: %s\n", filename, pipeline.trace.error);
+            return 0;
+        }
+        if (pipeline.trace.numberOfResources != pipeline.numberOfResources)
+        {
+            closeBinaryTrace(&pipeline.trace);
+            return 0;
+        }
+    }
+    else
+    {
+        if (!mapFile(filename, &file))
+        {
+            return 0;
+        }
+        initCommandParser(&pipeline.parser, file.data, file.size, pipeline.numberOfCustomers, pipeline.numberOfResources, NULL);
+    }
+
+    // Filas de até PIPELINE_RING_BYTES cada; a de snapshots guarda uma cópia do estado
+    size_t slotSize = (sizeof(PipelineSlot) + 2 * pipeline.numberOfResources * sizeof(int) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    unsigned long slotCount = 16;
+    while (slotCount * 2 * slotSize <= PIPELINE_RING_BYTES)
+    {
+        slotCount *= 2;
+    }
+    ringSpins = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? 1000 : 0;
+    pipeline.commands = createRing(slotCount, slotCount / 4, slotSize);
+    pipeline.decisions = createRing(slotCount, slotCount / 4, slotSize);
+    pipeline.snapshots = createRing(1, 1, snapshotBytes(state));
+    pipeline.rings[0] = pipeline.commands;
+    pipeline.rings[1] = pipeline.decisions;
+    pipeline.rings[2] = pipeline.snapshots;
+
+    int ok = pipeline.commands && pipeline.decisions && pipeline.snapshots;
+    for (int k = 0; ok && k < 3; k++)
+    {
+        pipeline.rings[k]->group = pipeline.rings;
+        pipeline.rings[k]->groupSize = 3;
+    }
+    pthread_t reader;
+    pthread_t formatter;
+    if (ok && pthread_create(&reader, NULL, readStage, &pipeline) != 0)
+    {
+        ok = 0;
+    }
+    else if (ok && pthread_create(&formatter, NULL, writeStage, &pipeline) != 0)
+    {
+        closeRing(pipeline.commands);
+        pthread_join(reader, NULL);
+        ok = 0;
+    }
+
+    if (ok)
+    {
+        decideStage(&pipeline);
+        pthread_join(reader, NULL);
+        pthread_join(formatter, NULL);
+    }
+    else
+    {
+        printf("Error: Unable to start the command pipeline\n");
+    }
+
+    // Comando inválido: avisa qual foi, como o modo serial
+    if (ok && pipeline.error)
+    {
+        if (binaryTrace)
+        {
+            printf("%s: record %ld: %s\n", filename, pipeline.position, pipeline.error);
+        }
+        else
+        {
+            printf("%s:%ld: %s\n", filename, pipeline.position, pipeline.error);
+        }
+        ok = 0;
+    }
+
+    destroyRing(pipeline.commands);
+    destroyRing(pipeline.decisions);
+    destroyRing(pipeline.snapshots);
+    if (binaryTrace)
+    {
+        closeBinaryTrace(&pipeline.trace);
+    }
+    else
+    {
+        unmapFile(&file);
+    }
+    return ok;
+}
+
+// Thread de leitura: cada comando vai direto para um slot da fila (o parser escreve os valores no próprio slot)
+static void* readStage(void *argument)
+{
+    Pipeline *pipeline = (Pipeline *)argument;
+    int numberOfResources = pipeline->numberOfResources;
+    Command command;
+    int status;
+
+    PipelineSlot *slot = (PipelineSlot *)ringReserve(pipeline->commands);
+    while (slot)
+    {
+        if (pipeline->binaryTrace)
+        {
+            status = nextTraceRecord(&pipeline->trace, &command);
+            slot->position = (long)pipeline->trace.nextRecord;
+            slot->error = pipeline->trace.error;
+            if (status > 0 && command.customerID >= pipeline->numberOfCustomers)
+            {
+                slot->error = "customer number out of range";
+                status = -1;
+            }
+            if (status > 0 && command.resources)
+            {
+                memcpy(slot->values, command.resources, numberOfResources * sizeof(int));
+            }
+        }
+        else
+        {
+            pipeline->parser.resources = slot->values;
+            status = nextCommand(&pipeline->parser, &command);
+            slot->position = pipeline->parser.lineNumber;
+            slot->error = pipeline->parser.error;
+        }
+
+        if (status <= 0)
+        {
+            slot->kind = PIPELINE_END;
+            if (status == 0)
+            {
+                slot->error = NULL;
+            }
+            ringPublish(pipeline->commands);
+            ringFinish(pipeline->commands);
+            break;
+        }
+        slot->kind = command.type;
+        slot->customerID = command.customerID;
+        ringPublish(pipeline->commands);
+        slot = (PipelineSlot *)ringReserve(pipeline->commands); // NULL se a decisão parou num erro
+    }
+    return NULL;
+}
+
+// Decisão, na thread que chamou runCommandPipeline: os comandos são aplicados um de cada vez, na ordem do arquivo
+static void decideStage(Pipeline *pipeline)
+{
+    BankerState *state = pipeline->state;
+    int numberOfResources = pipeline->numberOfResources;
+    size_t valueBytes = numberOfResources * sizeof(int);
+
+    for (;;)
+    {
+        STATS_POLL(); // Escreve as estatísticas se chegou um SIGUSR1
+        const PipelineSlot *command = (const PipelineSlot *)ringFront(pipeline->commands);
+        PipelineSlot *output = (PipelineSlot *)ringReserve(pipeline->decisions);
+        output->kind = command->kind;
+        output->customerID = command->customerID;
+
+        if (command->kind == COMMAND_REQUEST)
+        {
+            output->decision = admitRequest(state, pipeline->engine, command->customerID, command->values);
+            memcpy(output->values, command->values, valueBytes);
+            if (output->decision == REQUEST_NOT_AVAILABLE) // Só essa linha mostra os disponíveis
+            {
+                memcpy(output->values + numberOfResources, state->availableResources, valueBytes);
+            }
+        }
+        else if (command->kind == COMMAND_RELEASE)
+        {
+            output->decision = admitRelease(state, pipeline->engine, command->customerID, command->values);
+            memcpy(output->values, command->values, valueBytes);
+        }
+        else if (command->kind == COMMAND_PRINT)
+        {
+            // Copia o estado para a fila de snapshots (espera a escrita terminar o * anterior)
+            char *copy = (char *)ringReserve(pipeline->snapshots);
+            size_t matrixBytes = (size_t)state->numberOfCustomers * state->rowStride * sizeof(int);
+            memcpy(copy, state->maximumDemand, matrixBytes);
+            memcpy(copy + matrixBytes, state->currentAllocation, matrixBytes);
+            memcpy(copy + 2 * matrixBytes, state->remainingNeed, matrixBytes);
+            memcpy(copy + 3 * matrixBytes, state->availableResources, valueBytes);
+            ringPublish(pipeline->snapshots);
+            output->kind = PIPELINE_SNAPSHOT;
+        }
+        else if (command->kind == COMMAND_QUERY && decideQuery(pipeline, command, output))
+        {
+            // O resultado está em output (ou na fila de snapshots, num QM de todos os clientes)
+        }
+        else
+        {
+            // Fim do arquivo, linha mal formada, QM com direção negativa ou CP (o pipeline não grava checkpoints)
+            pipeline->error = command->kind == COMMAND_CHECKPOINT ? "CP needs --checkpoint FILE"
+                            : command->kind == COMMAND_QUERY ? "query direction must be non-negative" : command->error;
+            pipeline->position = command->position;
+            output->kind = PIPELINE_END;
+            ringPublish(pipeline->decisions);
+            ringFinish(pipeline->decisions);
+            if (command->kind == COMMAND_CHECKPOINT || command->kind == COMMAND_QUERY)
+            {
+                closeRing(pipeline->commands); // A leitura para em vez de esperar espaço na fila
+            }
+            ringRelease(pipeline->commands);
+            return;
+        }
+
+        ringRelease(pipeline->commands);
+        ringPublish(pipeline->decisions);
+    }
+}
+
+// QM na decisão: output recebe o resultado e a direção; num QM de todos os clientes, o resultado (numberOfCustomers
+// linhas) vai para o slot da fila de snapshots, que tem espaço de sobra. Retorna 0 se a direção tem valor negativo
+static int decideQuery(Pipeline *pipeline, const PipelineSlot *command, PipelineSlot *output)
+{
+    BankerState *state = pipeline->state;
+    int numberOfResources = pipeline->numberOfResources;
+    const int *direction = isZeroVector(command->values, numberOfResources) ? NULL : command->values;
+
+    output->decision = direction == NULL;
+    memcpy(output->values + numberOfResources, command->values, numberOfResources * sizeof(int));
+    if (command->customerID >= 0)
+    {
+        return maxGrantableRequest(state, pipeline->engine, command->customerID, direction, output->values);
+    }
+
+    int *grantable = (int *)ringReserve(pipeline->snapshots);
+    if (!maxGrantableAll(state, pipeline->engine, direction, grantable))
+    {
+        return 0; // O slot não foi publicado: a escrita nunca o vê
+    }
+    ringPublish(pipeline->snapshots);
+    return 1;
+}
+
+// Thread de escrita: formata as decisões na ordem em que chegam
+static void* writeStage(void *argument)
+{
+    Pipeline *pipeline = (Pipeline *)argument;
+    const BankerState *state = pipeline->state;
+    int numberOfResources = pipeline->numberOfResources;
+    OutputWriter *writer = pipeline->writer;
+
+    for (;;)
+    {
+        const PipelineSlot *output = (const PipelineSlot *)ringFront(pipeline->decisions);
+        if (output->kind == PIPELINE_END)
+        {
+            ringRelease(pipeline->decisions);
+            return NULL;
+        }
+
+        if (output->kind == COMMAND_REQUEST)
+        {
+            writeRequestDecision(writer, (RequestDecision)output->decision, output->customerID, output->values,
+                                 output->values + numberOfResources, numberOfResources);
+        }
+        else if (output->kind == COMMAND_RELEASE)
+        {
+            writeReleaseDecision(writer, output->decision, output->customerID, output->values, numberOfResources);
+        }
+        else if (output->kind == COMMAND_QUERY)
+        {
+            const int *direction = output->decision ? NULL : output->values + numberOfResources;
+            if (output->customerID >= 0)
+            {
+                writeGrantableQuery(writer, output->customerID, output->values, direction, numberOfResources);
+            }
+            else
+            {
+                const int *grantable = (const int *)ringFront(pipeline->snapshots);
+                for (int i = 0; i < state->numberOfCustomers; i++)
+                {
+                    writeGrantableQuery(writer, i, grantable + (size_t)i * numberOfResources, direction, numberOfResources);
+                }
+                ringRelease(pipeline->snapshots);
+            }
+        }
+        else
+        {
+            // O estado copiado pela decisão, visto como um BankerState
+            int *copy = (int *)ringFront(pipeline->snapshots);
+            size_t matrixLength = (size_t)state->numberOfCustomers * state->rowStride;
+            BankerState snapshot = *state;
+            snapshot.maximumDemand = copy;
+            snapshot.currentAllocation = copy + matrixLength;
+            snapshot.remainingNeed = copy + 2 * matrixLength;
+            snapshot.availableResources = copy + 3 * matrixLength;
+            writeStateSnapshot(writer, &snapshot);
+            ringRelease(pipeline->snapshots);
+        }
+        ringRelease(pipeline->decisions);
+    }
+}
+
+// Bytes da cópia do estado de um *: as três matrizes com padding e os disponíveis
+static size_t snapshotBytes(const BankerState *state)
+{
+    return (3 * (size_t)state->numberOfCustomers + 1) * state->rowStride * sizeof(int);
+}
+
+static SpscRing* createRing(unsigned long slotCount, unsigned long wakeBatch, size_t slotSize)
+{
+    SpscRing *ring = (SpscRing *)aligned_alloc(CACHE_LINE, (sizeof(SpscRing) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+    if (!ring)
+    {
+        return NULL;
+    }
+    memset(ring, 0, sizeof(SpscRing));
+
+    slotSize = (slotSize + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE; // Slots vizinhos não dividem linha de cache
+    ring->slotCount = slotCount;
+    ring->wakeBatch = wakeBatch;
+    ring->slotSize = slotSize;
+    ring->slots = (char *)aligned_alloc(CACHE_LINE, slotCount * slotSize);
+    if (!ring->slots)
+    {
+        free(ring);
+        return NULL;
+    }
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->wakeUp, NULL);
+    return ring;
+}
+
+static void destroyRing(SpscRing *ring)
+{
+    if (!ring)
+    {
+        return;
+    }
+
+    pthread_mutex_destroy(&ring->lock);
+    pthread_cond_destroy(&ring->wakeUp);
+    free(ring->slots);
+    free(ring);
+}
+
+// Produtor: o próximo slot livre (espera se a fila está cheia). NULL se o consumidor fechou a fila
+static void* ringReserve(SpscRing *ring)
+{
+    unsigned long tail = ring->tail;
+    while (tail - ring->cachedHead == ring->slotCount)
+    {
+        ring->cachedHead = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (tail - ring->cachedHead < ring->slotCount)
+        {
+            break;
+        }
+        if (__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE))
+        {
+            return NULL;
+        }
+        waitRing(ring, &ring->head, ring->cachedHead, &ring->producerWaiting);
+    }
+    if (__atomic_load_n(&ring->closed, __ATOMIC_RELAXED))
+    {
+        return NULL;
+    }
+    return ring->slots + (tail & (ring->slotCount - 1)) * ring->slotSize;
+}
+
+// Produtor: publica o slot de ringReserve
+static void ringPublish(SpscRing *ring)
+{
+    unsigned long tail = ring->tail + 1;
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_SEQ_CST); // seq_cst: ver consumerWaiting depois (ver waitRing)
+    if (__atomic_load_n(&ring->consumerWaiting, __ATOMIC_SEQ_CST))
+    {
+        wakeRing(ring, &ring->consumerWaiting, tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE));
+    }
+}
+
+// Produtor: publicou o último slot, acorda o consumidor sem esperar o bloco
+static void ringFinish(SpscRing *ring)
+{
+    wakeRing(ring, &ring->consumerWaiting, ring->wakeBatch);
+}
+
+// Consumidor: o slot mais antigo (espera se a fila está vazia)
+static void* ringFront(SpscRing *ring)
+{
+    unsigned long head = ring->head;
+    while (head == ring->cachedTail)
+    {
+        ring->cachedTail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head != ring->cachedTail)
+        {
+            break;
+        }
+        waitRing(ring, &ring->tail, head, &ring->consumerWaiting);
+    }
+    return ring->slots + (head & (ring->slotCount - 1)) * ring->slotSize;
+}
+
+// Consumidor: devolve o slot de ringFront
+static void ringRelease(SpscRing *ring)
+{
+    unsigned long head = ring->head + 1;
+    __atomic_store_n(&ring->head, head, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->producerWaiting, __ATOMIC_SEQ_CST))
+    {
+        wakeRing(ring, &ring->producerWaiting, ring->slotCount - (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head));
+    }
+}
+
+// Consumidor: não vai ler mais nada; o produtor que espera espaço (ou vai esperar) recebe NULL de ringReserve
+static void closeRing(SpscRing *ring)
+{
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&ring->lock);
+    pthread_cond_broadcast(&ring->wakeUp);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+// Espera *index sair de stale (ou a fila ser fechada): gira ringSpins voltas e depois dorme
+// Quem dorme marca *waiting antes de olhar o índice de novo, e quem publica escreve o índice antes de olhar *waiting
+// (os dois em seq_cst): um dos dois sempre vê o outro, e o sinal sob o mutex não se perde
+static void waitRing(SpscRing *ring, const unsigned long *index, unsigned long stale, int *waiting)
+{
+    for (int spin = 0; spin < ringSpins; spin++)
+    {
+        if (__atomic_load_n(index, __ATOMIC_ACQUIRE) != stale)
+        {
+            return;
+        }
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    wakeGroup(ring);
+    pthread_mutex_lock(&ring->lock);
+    __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(index, __ATOMIC_SEQ_CST) == stale && !__atomic_load_n(&ring->closed, __ATOMIC_SEQ_CST))
+    {
+        pthread_cond_wait(&ring->wakeUp, &ring->lock);
+    }
+    __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+// Acorda o outro lado se ele marcou que está dormindo e já há ready >= wakeBatch slots para ele
+static void wakeRing(SpscRing *ring, const int *waiting, unsigned long ready)
+{
+    if (ready >= ring->wakeBatch && __atomic_load_n(waiting, __ATOMIC_SEQ_CST))
+    {
+        pthread_mutex_lock(&ring->lock);
+        pthread_cond_broadcast(&ring->wakeUp);
+        pthread_mutex_unlock(&ring->lock);
+    }
+}
+
+// Antes de dormir: acorda quem espera em qualquer fila do pipeline, mesmo sem um bloco completo
+// (quem vai dormir não vai publicar nem liberar mais nada até acordar)
+static void wakeGroup(SpscRing *ring)
+{
+    for (int k = 0; k < ring->groupSize; k++)
+    {
+        wakeRing(ring->group[k], &ring->group[k]->consumerWaiting, ring->group[k]->wakeBatch);
+        wakeRing(ring->group[k], &ring->group[k]->producerWaiting, ring->group[k]->wakeBatch);
+    }
+}
@@ -0,0 +1,185 @@
+#include <string.h>
+#include "banker.h"
+
+// Consulta "e se": o maior pedido que um cliente consegue agora sem deixar o estado inseguro, sem alterar o estado
+//
+// Ao longo de uma direção d >= 0, ser aceito é monótono em t: se o pedido t * d deixa o estado seguro, qualquer pedido
+// menor também deixa. A sequência segura com o pedido maior serve para o menor: antes do cliente, work tem a diferença a
+// mais; o cliente precisa exatamente dessa diferença a mais; depois que ele termina, work é o mesmo nos dois casos.
+// Então o maior t sai de uma busca binária entre 0 e o limite dado pela NEED e pelos disponíveis, uma checagem por passo.
+//
+// A mesma conta mostra que a sequência guardada pelo motor incremental numa checagem aceita continua segura para o estado
+// sem o pedido, então as checagens da consulta não estragam o cache do motor (só o atualizam).
+//
+// Com alguma alocação negativa, o veredito de checkSafety depende da sua ordem gulosa e pode não ser monótono: a consulta
+// testa então cada t do limite para baixo (só acontece com RQ/RL de valores negativos).
+
+static int isGrantableSafe(const BankerState *state, SafetyEngine *engine, int customerID, const int *request);
+static int customerGrantable(const BankerState *state, SafetyEngine *engine, int customerID, const int *direction, int *grantable, int monotone);
+static int searchGrantable(const BankerState *state, SafetyEngine *engine, int customerID, const int *direction, int *grantable, int monotone);
+
+// Maior pedido que customerID consegue agora (admitRequest aceitaria), sem alterar o estado:
+// - direction NULL ou só zeros: por recurso, grantable[j] é o maior k tal que pedir k do recurso j (e nada dos outros) é
+//   aceito. Cada recurso é independente: o vetor inteiro de uma vez pode não ser aceito
+// - senão: o maior t tal que t * direction é aceito; grantable recebe t * direction
+// A segurança é checada como em admitRequest (motor ou checkSafety). Retorna 0 se direction tem valor negativo
+int maxGrantableRequest(const BankerState *state, SafetyEngine *engine, int customerID, const int *direction, int *grantable)
+{
+    int monotone = engine ? engine->negativeAllocationCount == 0 : !hasNegativeAllocation(state);
+    return customerGrantable(state, engine, customerID, direction, grantable, monotone);
+}
+
+// maxGrantableRequest para todos os clientes: grantable tem numberOfCustomers linhas de numberOfResources valores
+int maxGrantableAll(const BankerState *state, SafetyEngine *engine, const int *direction, int *grantable)
+{
+    int numberOfResources = state->numberOfResources;
+    int monotone = engine ? engine->negativeAllocationCount == 0 : !hasNegativeAllocation(state);
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        if (!customerGrantable(state, engine, i, direction, grantable + (size_t)i * numberOfResources, monotone))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int customerGrantable(const BankerState *state, SafetyEngine *engine, int customerID, const int *direction, int *grantable, int monotone)
+{
+    int numberOfResources = state->numberOfResources;
+    int perResource = 1;
+    for (int j = 0; direction && j < numberOfResources; j++)
+    {
+        if (direction[j] < 0)
+        {
+            return 0;
+        }
+        perResource &= direction[j] == 0;
+    }
+
+    if (!perResource)
+    {
+        searchGrantable(state, engine, customerID, direction, grantable, monotone);
+        return 1;
+    }
+
+    // Por recurso: uma busca na direção de cada recurso
+    int unit[numberOfResources + 1];
+    int single[numberOfResources + 1];
+    memset(unit, 0, numberOfResources * sizeof(int));
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        unit[j] = 1;
+        grantable[j] = searchGrantable(state, engine, customerID, unit, single, monotone);
+        unit[j] = 0;
+    }
+    return 1;
+}
+
+// Maior t tal que t * direction (direction >= 0, não nulo) é aceito; grantable recebe t * direction. Retorna t
+static int searchGrantable(const BankerState *state, SafetyEngine *engine, int customerID, const int *direction, int *grantable, int monotone)
+{
+    int numberOfResources = state->numberOfResources;
+    const int *need = needRow(state, customerID);
+    const int *available = state->availableResources;
+
+    // Limite dos RQ: t * d não passa da NEED nem dos disponíveis
+    int upper = -1;
+    int fitsAvailable = 1; // A NEED inteira cabe nos disponíveis (ver abaixo)
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        fitsAvailable &= need[j] <= available[j];
+        if (direction[j] > 0)
+        {
+            int limit = (need[j] < available[j] ? need[j] : available[j]) / direction[j];
+            upper = upper < 0 || limit < upper ? (limit > 0 ? limit : 0) : upper;
+        }
+    }
+
+    // Se a NEED do cliente cabe nos disponíveis, ele termina primeiro depois de qualquer pedido dentro dos limites
+    // (NEED - pedido <= disponíveis - pedido) e devolve tudo: o resto termina como no estado atual, se ele for seguro
+    // Senão, checa o limite direto (o caso comum) e só depois faz a busca binária: low é aceito, high não
+    int request[numberOfResources + 1];
+    int accepted = upper;
+    if (!monotone)
+    {
+        for (accepted = upper; accepted > 0; accepted--)
+        {
+            for (int j = 0; j < numberOfResources; j++)
+            {
+                request[j] = accepted * direction[j];
+            }
+            if (isGrantableSafe(state, engine, customerID, request))
+            {
+                break;
+            }
+        }
+    }
+    else if (upper > 0 && !(fitsAvailable && isGrantableSafe(state, engine, customerID, NULL)))
+    {
+        int low = 0;
+        int high = upper + 1;
+        for (int t = upper; high - low > 1; t = low + (high - low) / 2)
+        {
+            for (int j = 0; j < numberOfResources; j++)
+            {
+                request[j] = t * direction[j];
+            }
+            if (isGrantableSafe(state, engine, customerID, request))
+            {
+                low = t;
+            }
+            else
+            {
+                high = t;
+            }
+        }
+        accepted = low;
+    }
+    if (accepted < 0)
+    {
+        accepted = 0;
+    }
+
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        grantable[j] = accepted * direction[j];
+    }
+    return accepted;
+}
+
+// 1 se todos os valores são zero (a direção de um QM por recurso)
+int isZeroVector(const int *values, int length)
+{
+    int zero = 1;
+    for (int j = 0; j < length; j++)
+    {
+        zero &= values[j] == 0;
+    }
+    return zero;
+}
+
+// 1 se o estado com o pedido de customerID aplicado é seguro (request NULL: o estado atual)
+static int isGrantableSafe(const BankerState *state, SafetyEngine *engine, int customerID, const int *request)
+{
+    int rowLength = state->rowStride;
+    int available[rowLength];
+    int allocation[rowLength];
+    int need[rowLength];
+    memcpy(available, state->availableResources, rowLength * sizeof(int));
+    memcpy(allocation, allocationRow(state, customerID), rowLength * sizeof(int));
+    memcpy(need, needRow(state, customerID), rowLength * sizeof(int));
+    for (int j = 0; request && j < state->numberOfResources; j++)
+    {
+        available[j] -= request[j];
+        allocation[j] += request[j];
+        need[j] -= request[j];
+    }
+
+    SafetyOverlay overlay = { customerID, available, allocation, need };
+    if (engine)
+    {
+        return safetyEngineCheckOverlay(engine, state, &overlay);
+    }
+    return checkSafetyOverlay(state, &overlay, NULL);
+}
@@ -0,0 +1,581 @@
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+// Par (NEED, cliente) usado para montar as ordenações iniciais de cada recurso
+typedef struct
+{
+    int need;
+    int customer;
+} NeedEntry;
+
+#define SMALL_SORT_CUSTOMERS 64 // Até aqui as ordenações são montadas por inserção, sem as chamadas de comparação do qsort
+
+static int compareNeedEntries(const void *a, const void *b);
+static void sortNeedEntriesSmall(NeedEntry *entries, int count);
+static int checkEngine(SafetyEngine *engine, const BankerState *state, const SafetyOverlay *overlay, const int *changedCustomers, int changedCount);
+static int runEngineCheck(SafetyEngine *engine, const BankerState *state, const SafetyOverlay *overlay, const int *changedCustomers, int changedCount);
+static void advanceCursors(SafetyEngine *engine, const BankerState *state, int *queueTail);
+static void repositionCustomer(SafetyEngine *engine, const BankerState *state, int resource, int customerID);
+static void moveToFront(SafetyEngine *engine, int customerID);
+
+// Banker's Algorithm para checar se o estado é seguro baseado na alocação atual, necessidade restante e recursos disponíveis
+int bankerAlgorithm(const BankerState *state)
+{
+    // Vetor para armazenar a sequência segura dos clientes(processos) | A sequencia segura é a ordem em que os processos podem ser executados sem causar deadlock
+    int safeSequence[state->numberOfCustomers];
+    return checkSafety(state, safeSequence); // Retorna 1 se o estado for seguro e 0 caso contrário
+}
+
+// Checa se o estado é seguro (O estado é seguro se existe uma sequência segura) | O verdadeiro Banker's Algorithm
+int checkSafety(const BankerState *state, int *safeSequence)
+{
+    return checkSafetyOverlay(state, NULL, safeSequence);
+}
+
+// Mesma checagem sobre o estado com um pedido hipotético (overlay), sem escrever no estado; overlay NULL é o próprio estado
+int checkSafetyOverlay(const BankerState *state, const SafetyOverlay *overlay, int *safeSequence)
+{
+    const SafetyKernels *kernels = getSafetyKernels(); // Kernels SIMD (ou escalares) escolhidos para a CPU
+    int numberOfCustomers = state->numberOfCustomers;
+    int rowLength = state->rowStride; // O padding das linhas é zero, então os kernels processam a linha inteira sem resto
+    int finished[numberOfCustomers];  // Vetor para armazenar se a NEED do cliente foi satisfeita ou não
+    int work[rowLength];              // Vetor que copia os recursos disponíveis, representando os recursos disponíveis que podem ser usados
+    SafetyOverlay none = { -1, state->availableResources, NULL, NULL };
+    if (!overlay)
+    {
+        overlay = &none;
+    }
+
+    const WidthKernels *widthKernels = state->widthKernels; // Variante para 4, 8 ou 16 recursos, escolhida com o estado
+    if (widthKernels)
+    {
+        return widthKernels->checkSafety(state, overlay, safeSequence);
+    }
+
+    memcpy(work, overlay->available, rowLength * sizeof(int)); // Copia os recursos disponíveis para o vetor work
+    memset(finished, 0, numberOfCustomers * sizeof(int));             // Inicializa o vetor finished com 0
+
+    // Checa cada cliente até que todos os clientes tenham sido processados
+    // A linha do overlay não está na matriz: os clientes antes dele e depois dele são varridos pelo kernel e ele é testado à parte
+    int changed = overlay->customerID;
+    for (int k = 0; k < numberOfCustomers; k++)
+    {
+        // Primeiro cliente (na ordem) cuja NEED ainda não foi satisfeita e cabe nos recursos disponíveis (work)
+        int i = kernels->firstFitting(state->remainingNeed, rowLength, finished, 0, changed < 0 ? numberOfCustomers : changed, work);
+        if (i < 0 && changed >= 0)
+        {
+            i = !finished[changed] && kernels->needFitsWork(overlay->need, work, rowLength)
+                ? changed : kernels->firstFitting(state->remainingNeed, rowLength, finished, changed + 1, numberOfCustomers, work);
+        }
+        if (i < 0)
+        {
+            break; // Ninguém cabe em work, e work não muda mais
+        }
+
+        kernels->addToWork(work, overlayAllocationRow(state, overlay, i), rowLength); // Adiciona temporariamente os recursos alocados pelo cliente aos recursos disponíveis (work)
+        finished[i] = 1;             // Marca o cliente como processado
+        if (safeSequence != NULL)
+        {
+            safeSequence[k] = i;     // Adiciona o cliente a sequência segura
+        }
+    }
+
+    // Checa se todos os clientes foram processados
+    int finishedCount = 0;
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        finishedCount += finished[i];
+    }
+    STATS_PASSES(finishedCount + (finishedCount < numberOfCustomers)); // Uma passada por cliente que terminou, mais a que falhou
+    return finishedCount == numberOfCustomers; // 1: pode dale que é seguro, 0: não é seguro
+}
+
+// Cria o motor incremental de segurança a partir da necessidade restante atual
+// O motor mantém, para cada recurso, os clientes ordenados pela NEED daquele recurso e a última sequência segura conhecida,
+// assim cada checagem custa O(n·m) em vez do O(n²·m) de checkSafety
+SafetyEngine* createSafetyEngine(const BankerState *state)
+{
+    BankerArena measure = { NULL, 0, 0 };
+    arenaSafetyEngine(&measure, state->numberOfCustomers, state->numberOfResources);
+    BankerArena arena = { (char *)allocateArenaBlock(measure.used), measure.used, 0 };
+    if (!arena.base)
+    {
+        return NULL;
+    }
+
+    SafetyEngine *engine = arenaSafetyEngine(&arena, state->numberOfCustomers, state->numberOfResources);
+    rebuildSafetyEngine(engine, state);
+    return engine;
+}
+
+// Libera toda a memória do motor incremental (o bloco de createSafetyEngine)
+void destroySafetyEngine(SafetyEngine *engine)
+{
+    free(engine);
+}
+
+// Motor incremental vazio dentro da arena (as ordenações são montadas por rebuildSafetyEngine)
+// Retorna NULL se a arena não tem espaço (ou só mede: base NULL)
+SafetyEngine* arenaSafetyEngine(BankerArena *arena, int numberOfCustomers, int numberOfResources)
+{
+    int rowStride = bankerRowStride(numberOfResources);
+    size_t customerBytes = numberOfCustomers * sizeof(int);
+    SafetyEngine *engine = (SafetyEngine *)arenaAllocate(arena, sizeof(SafetyEngine));
+    int **order = (int **)arenaAllocate(arena, numberOfResources * sizeof(int *));
+    int **rank = (int **)arenaAllocate(arena, numberOfResources * sizeof(int *));
+    int *orderRows = (int *)arenaAllocate(arena, numberOfResources * customerBytes);
+    int *rankRows = (int *)arenaAllocate(arena, numberOfResources * customerBytes);
+    int *safeSequence = (int *)arenaAllocate(arena, customerBytes);
+    int *candidateSequence = (int *)arenaAllocate(arena, customerBytes);
+    int *finished = (int *)arenaAllocate(arena, customerBytes);
+    int *satisfiedCount = (int *)arenaAllocate(arena, customerBytes);
+    int *readyQueue = (int *)arenaAllocate(arena, customerBytes);
+    int *cursor = (int *)arenaAllocate(arena, numberOfResources * sizeof(int));
+    int *work = (int *)arenaAllocate(arena, rowStride * sizeof(int));
+    int *changedMark = (int *)arenaAllocate(arena, customerBytes);
+    int *negativeAllocation = (int *)arenaAllocate(arena, customerBytes);
+    NeedEntry *needEntries = (NeedEntry *)arenaAllocate(arena, numberOfCustomers * sizeof(NeedEntry));
+    if (!engine || !order || !rank || !orderRows || !rankRows || !safeSequence || !candidateSequence || !finished
+        || !satisfiedCount || !readyQueue || !cursor || !work || !changedMark || !negativeAllocation || !needEntries)
+    {
+        return NULL;
+    }
+
+    engine->numberOfCustomers = numberOfCustomers;
+    engine->numberOfResources = numberOfResources;
+    engine->rowStride = rowStride;
+    engine->order = order;
+    engine->rank = rank;
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        order[j] = orderRows + (size_t)j * numberOfCustomers;
+        rank[j] = rankRows + (size_t)j * numberOfCustomers;
+    }
+    engine->safeSequence = safeSequence;
+    engine->candidateSequence = candidateSequence;
+    engine->finished = finished;
+    engine->satisfiedCount = satisfiedCount;
+    engine->readyQueue = readyQueue;
+    engine->cursor = cursor;
+    engine->work = work;
+    engine->changedMark = changedMark;
+    engine->negativeAllocation = negativeAllocation;
+    engine->needEntries = needEntries;
+    return engine;
+}
+
+// Monta as ordenações de cada recurso a partir da necessidade restante atual e descarta a sequência guardada
+void rebuildSafetyEngine(SafetyEngine *engine, const BankerState *state)
+{
+    NeedEntry *entries = (NeedEntry *)engine->needEntries;
+    int numberOfCustomers = engine->numberOfCustomers;
+
+    // Ordena os clientes pela NEED de cada recurso
+    for (int j = 0; j < engine->numberOfResources; j++)
+    {
+        for (int i = 0; i < numberOfCustomers; i++)
+        {
+            entries[i].need = needRow(state, i)[j];
+            entries[i].customer = i;
+        }
+        if (numberOfCustomers <= SMALL_SORT_CUSTOMERS)
+        {
+            sortNeedEntriesSmall(entries, numberOfCustomers);
+        }
+        else
+        {
+            qsort(entries, numberOfCustomers, sizeof(NeedEntry), compareNeedEntries);
+        }
+
+        for (int p = 0; p < numberOfCustomers; p++)
+        {
+            engine->order[j][p] = entries[p].customer;
+            engine->rank[j][entries[p].customer] = p;
+        }
+    }
+
+    engine->negativeAllocationCount = 0;
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        engine->negativeAllocation[i] = rowHasNegative(allocationRow(state, i), state->rowStride);
+        engine->negativeAllocationCount += engine->negativeAllocation[i];
+    }
+    engine->hasSafeSequence = 0;
+}
+
+// Checa se o estado atual é seguro, com o mesmo veredito de checkSafety
+// changedCustomer é o cliente cuja NEED mudou desde a última chamada de safetyEngineUpdateCustomer (ou -1 se nenhum),
+// ou seja, o único cliente que pode estar fora de ordem nas ordenações por recurso
+int safetyEngineCheck(SafetyEngine *engine, const BankerState *state, int changedCustomer)
+{
+    return safetyEngineCheckChanged(engine, state, &changedCustomer, changedCustomer >= 0 ? 1 : 0);
+}
+
+// Mesma checagem com vários clientes alterados desde a última atualização das ordenações (pedidos de um lote)
+// Os clientes alterados são pulados pelos cursores e testados diretamente; repetições na lista são permitidas
+int safetyEngineCheckChanged(SafetyEngine *engine, const BankerState *state, const int *changedCustomers, int changedCount)
+{
+    SafetyOverlay none = { -1, state->availableResources, NULL, NULL };
+    return checkEngine(engine, state, &none, changedCustomers, changedCount);
+}
+
+// Checa um pedido hipotético sem aplicá-lo: o estado é o da última atualização das ordenações, e só overlay->customerID muda
+// Se for seguro, a sequência guardada passa a ser a do estado com o pedido, que deve ser aplicado em seguida
+int safetyEngineCheckOverlay(SafetyEngine *engine, const BankerState *state, const SafetyOverlay *overlay)
+{
+    return checkEngine(engine, state, overlay, &overlay->customerID, 1);
+}
+
+// Só o caminho rápido de checkEngine, para um pedido de customerID (sem valor negativo, já dentro dos limites) ainda não
+// aplicado: a NEED do cliente caber nos disponíveis antes do pedido é o mesmo que caber depois (os dois perdem o pedido)
+// Retorna 1 se aprovado, e a sequência guardada passa a ser a do estado com o pedido; 0 não diz nada (falta a checagem)
+int safetyEngineFastApproval(SafetyEngine *engine, const BankerState *state, int customerID)
+{
+    if (!engine->hasSafeSequence || engine->negativeAllocationCount > 0
+        || !getSafetyKernels()->needFitsWork(needRow(state, customerID), state->availableResources, engine->rowStride))
+    {
+        return 0;
+    }
+    moveToFront(engine, customerID);
+    engine->fastApprovals++;
+    STATS_COUNT(fastApprovals);
+    return 1;
+}
+
+static int checkEngine(SafetyEngine *engine, const BankerState *state, const SafetyOverlay *overlay, const int *changedCustomers, int changedCount)
+{
+    // Com alguma alocação negativa, terminar um cliente pode diminuir work: as ordenações e a sequência guardada não valem,
+    // e só a ordem gulosa de checkSafety dá o mesmo veredito
+    int negativeCount = engine->negativeAllocationCount;
+    for (int c = 0; c < changedCount && negativeCount == 0; c++)
+    {
+        negativeCount += rowHasNegative(overlayAllocationRow(state, overlay, changedCustomers[c]), state->rowStride);
+    }
+    if (negativeCount > 0)
+    {
+        engine->fullChecks++;
+        if (!checkSafetyOverlay(state, overlay, engine->candidateSequence))
+        {
+            return 0;
+        }
+        // A sequência de checkSafety é segura para o estado novo, então continua valendo como a sequência guardada
+        int *sequence = engine->candidateSequence;
+        engine->candidateSequence = engine->safeSequence;
+        engine->safeSequence = sequence;
+        engine->hasSafeSequence = 1;
+        return 1;
+    }
+
+    // Caminho rápido: o estado antes da mudança era seguro (a sequência guardada) e o único cliente alterado termina já
+    // com os disponíveis. O pedido só move recursos entre os disponíveis e a alocação dele, então depois que ele termina
+    // work volta a ser os disponíveis de antes mais a alocação antiga dele, e a sequência antiga (sem ele) termina o resto
+    if (changedCount == 1 && engine->hasSafeSequence
+        && getSafetyKernels()->needFitsWork(overlayNeedRow(state, overlay, changedCustomers[0]), overlay->available, engine->rowStride))
+    {
+        moveToFront(engine, changedCustomers[0]);
+        engine->fastApprovals++;
+        STATS_COUNT(fastApprovals);
+        STATS_PASSES(0);
+        return 1;
+    }
+
+    for (int c = 0; c < changedCount; c++)
+    {
+        engine->changedMark[changedCustomers[c]] = 1;
+    }
+    int safe = runEngineCheck(engine, state, overlay, changedCustomers, changedCount);
+    for (int c = 0; c < changedCount; c++)
+    {
+        engine->changedMark[changedCustomers[c]] = 0;
+    }
+    return safe;
+}
+
+static int runEngineCheck(SafetyEngine *engine, const BankerState *state, const SafetyOverlay *overlay, const int *changedCustomers, int changedCount)
+{
+    const SafetyKernels *kernels = getSafetyKernels();
+    int numberOfCustomers = engine->numberOfCustomers;
+    int numberOfResources = engine->numberOfResources;
+    int rowLength = engine->rowStride;
+    int *work = engine->work;
+    int *finished = engine->finished;
+    int *sequence = engine->candidateSequence;
+    int completed = 0; // Número de clientes já processados
+
+    if (numberOfResources == 0)
+    {
+        return 1; // Sem recursos qualquer cliente pode terminar
+    }
+
+    memcpy(work, overlay->available, rowLength * sizeof(int)); // Copia os recursos disponíveis (com o padding) para o vetor work
+    memset(finished, 0, numberOfCustomers * sizeof(int));
+
+    // Primeiro reaproveita a última sequência segura: processa os clientes na mesma ordem até o primeiro que não cabe em work
+    // Terminar um cliente só aumenta work, então esse prefixo continua válido para o resto da checagem
+    if (engine->hasSafeSequence)
+    {
+        const WidthKernels *widthKernels = state->widthKernels;
+        if (widthKernels)
+        {
+            completed = widthKernels->walkSequence(state, overlay, engine->safeSequence, work, finished);
+        }
+        else
+        {
+            while (completed < numberOfCustomers)
+            {
+                int i = engine->safeSequence[completed];
+                if (!kernels->needFitsWork(overlayNeedRow(state, overlay, i), work, rowLength))
+                {
+                    break;
+                }
+                kernels->addToWork(work, overlayAllocationRow(state, overlay, i), rowLength);
+                finished[i] = 1;
+                completed++;
+            }
+        }
+        memcpy(sequence, engine->safeSequence, completed * sizeof(int)); // O prefixo percorrido é o mesmo da sequência guardada
+
+        // A sequência antiga continua segura, nada a reparar
+        if (completed == numberOfCustomers)
+        {
+            engine->cacheHits++;
+            STATS_COUNT(cacheHits);
+            STATS_PASSES(1);
+            return 1;
+        }
+    }
+    engine->cacheMisses++;
+    STATS_COUNT(cacheMisses);
+
+    // Com --threads N o resto é terminado pela checagem paralela, a partir do prefixo percorrido
+    // (sem alocação negativa, já descartada em checkEngine); sem memória para ela, segue com o reparo serial
+    int parallelSafe = engine->pool ? checkSafetyParallelRepair(engine->pool, state, overlay, work, finished, sequence, completed) : -1;
+    if (parallelSafe == 0)
+    {
+        STATS_PASSES(1 + engine->hasSafeSequence);
+        return 0;
+    }
+    if (parallelSafe == 1)
+    {
+        STATS_PASSES(1 + engine->hasSafeSequence);
+        engine->candidateSequence = engine->safeSequence;
+        engine->safeSequence = sequence;
+        engine->hasSafeSequence = 1;
+        return 1;
+    }
+
+    // Repara o resto da sequência percorrendo as ordenações por recurso:
+    // um cliente fica pronto quando a NEED de todos os seus recursos cabe em work
+    int queueHead = 0;
+    int queueTail = 0;
+    memset(engine->satisfiedCount, 0, numberOfCustomers * sizeof(int));
+    memset(engine->cursor, 0, numberOfResources * sizeof(int));
+    advanceCursors(engine, state, &queueTail);
+
+    while (completed < numberOfCustomers)
+    {
+        if (queueHead == queueTail)
+        {
+            // Os clientes alterados não estão nas ordenações, então são checados diretamente
+            // Quem cabe entra na fila de uma vez (work só cresce) e fica marcado com satisfiedCount = numberOfResources
+            for (int c = 0; c < changedCount; c++)
+            {
+                int candidate = changedCustomers[c];
+                if (!finished[candidate] && engine->satisfiedCount[candidate] != numberOfResources
+                    && kernels->needFitsWork(overlayNeedRow(state, overlay, candidate), work, rowLength))
+                {
+                    engine->satisfiedCount[candidate] = numberOfResources;
+                    engine->readyQueue[queueTail++] = candidate;
+                }
+            }
+            if (queueHead == queueTail)
+            {
+                STATS_PASSES(1 + engine->hasSafeSequence); // A sequência guardada (se havia) e o reparo
+                return 0; // Ninguém mais cabe em work, não é seguro
+            }
+        }
+        int i = engine->readyQueue[queueHead++];
+
+        if (finished[i])
+        {
+            continue;
+        }
+        kernels->addToWork(work, overlayAllocationRow(state, overlay, i), rowLength);
+        finished[i] = 1;
+        sequence[completed++] = i;
+        advanceCursors(engine, state, &queueTail);
+    }
+
+    // Guarda a nova sequência segura para as próximas checagens
+    STATS_PASSES(1 + engine->hasSafeSequence);
+    engine->candidateSequence = engine->safeSequence;
+    engine->safeSequence = sequence;
+    engine->hasSafeSequence = 1;
+    return 1;
+}
+
+// Atualiza a posição de um cliente nas ordenações depois que a sua NEED mudou de vez (pedido aceito ou liberação)
+void safetyEngineUpdateCustomer(SafetyEngine *engine, const BankerState *state, int customerID)
+{
+    for (int j = 0; j < engine->numberOfResources; j++)
+    {
+        repositionCustomer(engine, state, j, customerID);
+    }
+
+    int negative = rowHasNegative(allocationRow(state, customerID), state->rowStride);
+    engine->negativeAllocationCount += negative - engine->negativeAllocation[customerID];
+    engine->negativeAllocation[customerID] = negative;
+}
+
+// Atualiza as ordenações depois que a NEED de vários clientes mudou de vez (lote de pedidos aceitos)
+// Todos os alterados ficam marcados e cada um é reposicionado ignorando os que ainda estão fora de ordem
+void safetyEngineUpdateCustomers(SafetyEngine *engine, const BankerState *state, const int *customers, int count)
+{
+    for (int c = 0; c < count; c++)
+    {
+        engine->changedMark[customers[c]] = 1;
+    }
+    for (int c = 0; c < count; c++)
+    {
+        int customerID = customers[c];
+        if (!engine->changedMark[customerID])
+        {
+            continue; // Repetido no lote, já reposicionado
+        }
+        engine->changedMark[customerID] = 0;
+        safetyEngineUpdateCustomer(engine, state, customerID);
+    }
+}
+
+// Coloca o cliente no início da sequência segura guardada, mantendo a ordem dos outros
+static void moveToFront(SafetyEngine *engine, int customerID)
+{
+    int *sequence = engine->candidateSequence;
+    int length = 1;
+    sequence[0] = customerID;
+    for (int k = 0; k < engine->numberOfCustomers; k++)
+    {
+        if (engine->safeSequence[k] != customerID)
+        {
+            sequence[length++] = engine->safeSequence[k];
+        }
+    }
+    engine->candidateSequence = engine->safeSequence;
+    engine->safeSequence = sequence;
+}
+
+// Move o cliente em order[resource] para a posição da sua NEED atual
+// Clientes marcados em changedMark (ainda fora de ordem) são ignorados na comparação e só deslocados
+static void repositionCustomer(SafetyEngine *engine, const BankerState *state, int resource, int customerID)
+{
+    int *order = engine->order[resource];
+    int *rank = engine->rank[resource];
+    int need = needRow(state, customerID)[resource];
+    int p = rank[customerID];
+    int target = p;
+
+    // Procura para a esquerda o primeiro cliente com NEED maior
+    for (int q = p - 1; q >= 0; q--)
+    {
+        if (engine->changedMark[order[q]])
+        {
+            continue;
+        }
+        if (needRow(state, order[q])[resource] <= need)
+        {
+            break;
+        }
+        target = q;
+    }
+    // Ou para a direita o último com NEED menor
+    if (target == p)
+    {
+        for (int q = p + 1; q < engine->numberOfCustomers; q++)
+        {
+            if (engine->changedMark[order[q]])
+            {
+                continue;
+            }
+            if (needRow(state, order[q])[resource] >= need)
+            {
+                break;
+            }
+            target = q;
+        }
+    }
+
+    // Desloca os clientes entre as duas posições
+    for (; p > target; p--)
+    {
+        order[p] = order[p - 1];
+        rank[order[p]] = p;
+    }
+    for (; p < target; p++)
+    {
+        order[p] = order[p + 1];
+        rank[order[p]] = p;
+    }
+    order[p] = customerID;
+    rank[customerID] = p;
+}
+
+// Avança o cursor de cada recurso sobre os clientes cuja NEED daquele recurso cabe em work
+// e coloca na fila os clientes que passaram a caber em todos os recursos
+static void advanceCursors(SafetyEngine *engine, const BankerState *state, int *queueTail)
+{
+    int numberOfCustomers = engine->numberOfCustomers;
+    int numberOfResources = engine->numberOfResources;
+
+    for (int j = 0; j < numberOfResources; j++)
+    {
+        int *order = engine->order[j];
+        int p = engine->cursor[j];
+
+        while (p < numberOfCustomers)
+        {
+            int i = order[p];
+            if (!engine->changedMark[i]) // A posição de um cliente alterado está desatualizada, então ele é pulado
+            {
+                if (needRow(state, i)[j] > engine->work[j])
+                {
+                    break;
+                }
+                if (++engine->satisfiedCount[i] == numberOfResources && !engine->finished[i])
+                {
+                    engine->readyQueue[(*queueTail)++] = i;
+                }
+            }
+            p++;
+        }
+        engine->cursor[j] = p;
+    }
+}
+
+static int compareNeedEntries(const void *a, const void *b)
+{
+    const NeedEntry *x = (const NeedEntry *)a;
+    const NeedEntry *y = (const NeedEntry *)b;
+    if (x->need != y->need)
+    {
+        return x->need < y->need ? -1 : 1;
+    }
+    return x->customer - y->customer;
+}
+
+// Ordenação por inserção, na mesma ordem de compareNeedEntries (NEED, depois o cliente): com poucos clientes, criar muitos
+// handles pequenos (libbanker) não paga uma chamada de função por comparação
+static void sortNeedEntriesSmall(NeedEntry *entries, int count)
+{
+    for (int k = 1; k < count; k++)
+    {
+        NeedEntry entry = entries[k];
+        int p = k;
+        while (p > 0 && (entries[p - 1].need > entry.need || (entries[p - 1].need == entry.need && entries[p - 1].customer > entry.customer)))
+        {
+            entries[p] = entries[p - 1];
+            p--;
+        }
+        entries[p] = entry;
+    }
+}
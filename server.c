@@ -0,0 +1,466 @@
+#define _GNU_SOURCE // accept4
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "banker.h"
+
+// Servidor do banqueiro num socket Unix (--serve PATH): as matrizes ficam na memória e os comandos chegam pelo socket
+// Um único laço com epoll atende todos os clientes, então os comandos são decididos um de cada vez, na ordem em que são lidos
+//
+// Protocolo (versão 1, little-endian), pensado para ser curto:
+//   ao conectar, o servidor manda 16 bytes: "BNKS" | versão u16 | reservado u16 | número de clientes u32 | número de recursos u32
+//   cada comando é um u32 com cliente << 2 | opcode (1 = RQ, 2 = RL, 3 = *), seguido de um int32 por recurso em RQ e RL
+//   a resposta de RQ/RL é 1 byte de status (SERVER_STATUS_*); a de * é o status 0, o tamanho u32 e o mesmo texto que iria para result.txt
+//   um opcode inválido recebe SERVER_STATUS_INVALID e a conexão é fechada (não dá para saber onde começa o próximo comando)
+#define SERVER_MAGIC "BNKS"
+#define SERVER_MAX_EVENTS 64
+#define CLIENT_INPUT_SIZE 65536                // Bytes lidos de cada cliente por vez
+#define CLIENT_OUTPUT_LIMIT OUTPUT_BUFFER_SIZE // Com mais respostas pendentes que isso, os comandos do cliente param de ser decididos (e lidos) até ele consumir
+
+typedef struct ServerClient
+{
+    int socket;
+    char *input;           // Bytes recebidos e ainda não processados
+    size_t inputLength;
+    size_t inputCapacity;
+    OutputWriter *output;  // Respostas pendentes (writer em memória)
+    size_t outputSent;     // Bytes de output já enviados
+    uint32_t events;       // Eventos registrados no epoll
+    struct ServerClient *next;     // Lista dos clientes conectados
+    struct ServerClient *previous;
+} ServerClient;
+
+struct BankerServer
+{
+    int listenSocket;
+    int epollDescriptor;
+    int wakeDescriptor;    // eventfd usado por stopBankerServer
+    char socketPath[sizeof(((struct sockaddr_un *)0)->sun_path)];
+    BankerState *state;
+    SafetyEngine *engine;
+    size_t messageSize;    // Tamanho de um RQ/RL
+    int *values;           // Valores do comando atual (alinhados)
+    ServerClient *clients; // Clientes conectados
+};
+
+static void acceptClients(BankerServer *server);
+static void closeClient(BankerServer *server, ServerClient *client);
+static int readClient(BankerServer *server, ServerClient *client);
+static int processClientInput(BankerServer *server, ServerClient *client);
+static int serveClientInput(BankerServer *server, ServerClient *client);
+static int sendClientOutput(BankerServer *server, ServerClient *client);
+static void updateClientEvents(BankerServer *server, ServerClient *client);
+
+// Cria o socket em socketPath (um arquivo antigo no mesmo caminho é removido) e prepara o epoll
+// O estado e o motor continuam sendo de quem chama; o servidor só os usa
+BankerServer* createBankerServer(const char *socketPath, BankerState *state, SafetyEngine *engine)
+{
+    struct sockaddr_un address;
+    if (strlen(socketPath) >= sizeof(address.sun_path))
+    {
+        return NULL;
+    }
+
+    BankerServer *server = (BankerServer *)calloc(1, sizeof(BankerServer));
+    if (!server)
+    {
+        return NULL;
+    }
+    server->listenSocket = -1;
+    server->epollDescriptor = -1;
+    server->wakeDescriptor = -1;
+    server->state = state;
+    server->engine = engine;
+    server->messageSize = 4 + 4 * (size_t)state->numberOfResources;
+    server->values = (int *)malloc((state->numberOfResources + 1) * sizeof(int));
+    strcpy(server->socketPath, socketPath);
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, socketPath);
+    unlink(socketPath);
+
+    server->listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    server->epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    server->wakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!server->values || server->listenSocket < 0 || server->epollDescriptor < 0 || server->wakeDescriptor < 0
+        || bind(server->listenSocket, (struct sockaddr *)&address, sizeof(address)) != 0
+        || listen(server->listenSocket, SOMAXCONN) != 0)
+    {
+        destroyBankerServer(server);
+        return NULL;
+    }
+
+    // O socket de escuta é identificado por data.ptr = NULL e o eventfd por data.ptr = server
+    struct epoll_event event = { .events = EPOLLIN, .data.ptr = NULL };
+    epoll_ctl(server->epollDescriptor, EPOLL_CTL_ADD, server->listenSocket, &event);
+    event.data.ptr = server;
+    epoll_ctl(server->epollDescriptor, EPOLL_CTL_ADD, server->wakeDescriptor, &event);
+    return server;
+}
+
+// Fecha o socket (e remove o arquivo). Os clientes são fechados por runBankerServer antes de retornar
+void destroyBankerServer(BankerServer *server)
+{
+    if (!server)
+    {
+        return;
+    }
+
+    if (server->listenSocket >= 0)
+    {
+        close(server->listenSocket);
+        unlink(server->socketPath);
+    }
+    if (server->epollDescriptor >= 0)
+    {
+        close(server->epollDescriptor);
+    }
+    if (server->wakeDescriptor >= 0)
+    {
+        close(server->wakeDescriptor);
+    }
+    free(server->values);
+    free(server);
+}
+
+// Pede para runBankerServer retornar. Pode ser chamada de outra thread ou de um tratador de sinal
+void stopBankerServer(BankerServer *server)
+{
+    uint64_t one = 1;
+    ssize_t written = write(server->wakeDescriptor, &one, sizeof(one));
+    (void)written;
+}
+
+// Atende os clientes até stopBankerServer. Retorna 1, ou 0 se o epoll falhar
+int runBankerServer(BankerServer *server)
+{
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    ServerClient *closing[SERVER_MAX_EVENTS];
+    int running = 1;
+    int ok = 1;
+
+    while (running)
+    {
+        int count = epoll_wait(server->epollDescriptor, events, SERVER_MAX_EVENTS, -1);
+        STATS_POLL(); // SIGUSR1 interrompe o epoll_wait
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            ok = 0;
+            break;
+        }
+
+        int closingCount = 0;
+        for (int e = 0; e < count; e++)
+        {
+            void *tag = events[e].data.ptr;
+            if (tag == NULL)
+            {
+                acceptClients(server);
+                continue;
+            }
+            if (tag == server)
+            {
+                running = 0;
+                continue;
+            }
+
+            ServerClient *client = (ServerClient *)tag;
+            if (client->events == 0)
+            {
+                continue; // Já marcado para fechar nesta volta
+            }
+            int alive = 1;
+            if (events[e].events & EPOLLIN)
+            {
+                alive = readClient(server, client); // Com EPOLLHUP ainda pode haver comandos para ler antes do fim
+            }
+            else if (events[e].events & (EPOLLHUP | EPOLLERR))
+            {
+                alive = 0;
+            }
+            if (alive && (events[e].events & EPOLLOUT))
+            {
+                alive = serveClientInput(server, client); // Envia e retoma os comandos que pararam no limite de respostas
+            }
+
+            if (alive)
+            {
+                updateClientEvents(server, client);
+            }
+            else
+            {
+                // Fecha depois de tratar todos os eventos desta volta
+                epoll_ctl(server->epollDescriptor, EPOLL_CTL_DEL, client->socket, NULL);
+                client->events = 0;
+                closing[closingCount++] = client;
+            }
+        }
+        for (int c = 0; c < closingCount; c++)
+        {
+            closeClient(server, closing[c]);
+        }
+    }
+
+    // Fecha os clientes que continuam conectados
+    while (server->clients)
+    {
+        epoll_ctl(server->epollDescriptor, EPOLL_CTL_DEL, server->clients->socket, NULL);
+        closeClient(server, server->clients);
+    }
+    return ok;
+}
+
+// Aceita todas as conexões pendentes e manda o cabeçalho para cada uma
+static void acceptClients(BankerServer *server)
+{
+    while (1)
+    {
+        int socket = accept4(server->listenSocket, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (socket < 0)
+        {
+            return; // EAGAIN: acabaram as conexões pendentes (outros erros também param por aqui)
+        }
+
+        ServerClient *client = (ServerClient *)calloc(1, sizeof(ServerClient));
+        size_t inputCapacity = CLIENT_INPUT_SIZE > 2 * server->messageSize ? CLIENT_INPUT_SIZE : 2 * server->messageSize;
+        if (client)
+        {
+            client->socket = socket;
+            client->input = (char *)malloc(inputCapacity);
+            client->inputCapacity = inputCapacity;
+            client->output = openMemoryWriter(4096);
+        }
+        if (!client || !client->input || !client->output)
+        {
+            if (client)
+            {
+                free(client->input);
+                closeOutputWriter(client->output);
+                free(client);
+            }
+            close(socket);
+            continue;
+        }
+
+        // Cabeçalho
+        uint16_t version = SERVER_PROTOCOL_VERSION;
+        uint16_t reserved = 0;
+        uint32_t customers = server->state->numberOfCustomers;
+        uint32_t resources = server->state->numberOfResources;
+        writerPutBytes(client->output, SERVER_MAGIC, 4);
+        writerPutBytes(client->output, (const char *)&version, 2);
+        writerPutBytes(client->output, (const char *)&reserved, 2);
+        writerPutBytes(client->output, (const char *)&customers, 4);
+        writerPutBytes(client->output, (const char *)&resources, 4);
+
+        client->events = EPOLLIN;
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = client };
+        epoll_ctl(server->epollDescriptor, EPOLL_CTL_ADD, socket, &event);
+        client->next = server->clients;
+        if (server->clients)
+        {
+            server->clients->previous = client;
+        }
+        server->clients = client;
+
+        if (sendClientOutput(server, client))
+        {
+            updateClientEvents(server, client);
+        }
+        else
+        {
+            epoll_ctl(server->epollDescriptor, EPOLL_CTL_DEL, socket, NULL);
+            closeClient(server, client);
+        }
+    }
+}
+
+static void closeClient(BankerServer *server, ServerClient *client)
+{
+    if (client->previous)
+    {
+        client->previous->next = client->next;
+    }
+    else
+    {
+        server->clients = client->next;
+    }
+    if (client->next)
+    {
+        client->next->previous = client->previous;
+    }
+    close(client->socket);
+    free(client->input);
+    closeOutputWriter(client->output);
+    free(client);
+}
+
+// Lê o que estiver disponível (uma leitura por evento, para um cliente não monopolizar o laço) e decide os comandos completos
+// Retorna 0 se a conexão deve ser fechada
+static int readClient(BankerServer *server, ServerClient *client)
+{
+    ssize_t received = read(client->socket, client->input + client->inputLength, client->inputCapacity - client->inputLength);
+    if (received == 0)
+    {
+        return 0; // O cliente fechou a conexão
+    }
+    if (received < 0)
+    {
+        return errno == EAGAIN || errno == EINTR;
+    }
+    client->inputLength += received;
+    return serveClientInput(server, client);
+}
+
+// Decide os comandos do buffer de entrada e envia as respostas, enquanto o socket aceitar tudo o que foi escrito
+// Comandos que ficaram no buffer pelo limite de respostas são retomados aqui quando EPOLLOUT esvazia a saída
+// Retorna 0 se a conexão deve ser fechada
+static int serveClientInput(BankerServer *server, ServerClient *client)
+{
+    while (1)
+    {
+        size_t inputLength = client->inputLength;
+        int valid = processClientInput(server, client);
+        if (!sendClientOutput(server, client) || !valid)
+        {
+            return 0;
+        }
+        if (client->inputLength == inputLength || client->output->length > 0)
+        {
+            return 1; // Nada mais para decidir, ou o resto das respostas espera EPOLLOUT
+        }
+    }
+}
+
+// Decide os comandos completos do buffer de entrada e escreve as respostas. Retorna 0 se houve um opcode inválido
+// Para quando as respostas pendentes passam de CLIENT_OUTPUT_LIMIT: uma leitura cheia de * não acumula milhares de estados
+static int processClientInput(BankerServer *server, ServerClient *client)
+{
+    BankerState *state = server->state;
+    int numberOfResources = state->numberOfResources;
+    const char *input = client->input;
+    size_t offset = 0;
+    int valid = 1;
+
+    while (client->inputLength - offset >= 4 && client->output->length - client->outputSent < CLIENT_OUTPUT_LIMIT)
+    {
+        uint32_t word;
+        memcpy(&word, input + offset, 4);
+        uint32_t opcode = word & 3;
+        uint32_t customerID = word >> 2;
+        char status;
+
+        if (opcode == COMMAND_OPCODE_SNAPSHOT)
+        {
+            offset += 4;
+            status = SERVER_STATUS_OK;
+            writerPutBytes(client->output, &status, 1);
+
+            // O tamanho só é conhecido depois do texto: reserva os 4 bytes e preenche no fim (pela posição, o buffer pode mudar)
+            uint32_t length = 0;
+            size_t lengthPosition = client->output->length;
+            writerPutBytes(client->output, (const char *)&length, 4);
+            writeStateSnapshot(client->output, state);
+            if (!client->output->failed)
+            {
+                length = (uint32_t)(client->output->length - lengthPosition - 4);
+                memcpy(client->output->buffer + lengthPosition, &length, 4);
+            }
+            continue;
+        }
+        if (opcode != COMMAND_OPCODE_REQUEST && opcode != COMMAND_OPCODE_RELEASE)
+        {
+            status = SERVER_STATUS_INVALID;
+            writerPutBytes(client->output, &status, 1);
+            valid = 0;
+            offset = client->inputLength;
+            break;
+        }
+        if (client->inputLength - offset < server->messageSize)
+        {
+            break; // Comando incompleto: espera o resto
+        }
+
+        memcpy(server->values, input + offset + 4, numberOfResources * sizeof(int));
+        offset += server->messageSize;
+
+        if (customerID >= (uint32_t)state->numberOfCustomers)
+        {
+            status = SERVER_STATUS_INVALID;
+        }
+        else if (opcode == COMMAND_OPCODE_REQUEST)
+        {
+            status = (char)admitRequest(state, server->engine, (int)customerID, server->values);
+        }
+        else
+        {
+            status = admitRelease(state, server->engine, (int)customerID, server->values) ? SERVER_STATUS_OK : SERVER_STATUS_EXCEEDS_ALLOCATION;
+        }
+        writerPutBytes(client->output, &status, 1);
+    }
+
+    // Guarda o comando incompleto no início do buffer
+    memmove(client->input, input + offset, client->inputLength - offset);
+    client->inputLength -= offset;
+    return valid;
+}
+
+// Envia o que der das respostas pendentes. Retorna 0 se a conexão caiu ou faltou memória para as respostas
+static int sendClientOutput(BankerServer *server, ServerClient *client)
+{
+    OutputWriter *output = client->output;
+    if (output->failed)
+    {
+        return 0;
+    }
+
+    while (client->outputSent < output->length)
+    {
+        ssize_t sent = send(client->socket, output->buffer + client->outputSent, output->length - client->outputSent, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno == EAGAIN; // O resto vai quando o socket aceitar mais (EPOLLOUT)
+        }
+        client->outputSent += sent;
+    }
+    output->length = 0;
+    client->outputSent = 0;
+    return 1;
+}
+
+// Espera EPOLLOUT só com respostas pendentes, e para de ler quem tem respostas demais acumuladas
+static void updateClientEvents(BankerServer *server, ServerClient *client)
+{
+    size_t pending = client->output->length - client->outputSent;
+    uint32_t events = 0;
+    if (pending < CLIENT_OUTPUT_LIMIT && client->inputLength < client->inputCapacity)
+    {
+        events |= EPOLLIN;
+    }
+    if (pending > 0)
+    {
+        events |= EPOLLOUT;
+    }
+
+    if (events != client->events)
+    {
+        struct epoll_event event = { .events = events, .data.ptr = client };
+        epoll_ctl(server->epollDescriptor, EPOLL_CTL_MOD, client->socket, &event);
+        client->events = events;
+    }
+}
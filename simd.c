@@ -0,0 +1,184 @@
+#include <string.h>
+#include "banker.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BANKER_X86 1
+#endif
+
+// Kernels escalares: funcionam em qualquer CPU e para qualquer tamanho
+static inline int scalarNeedFitsWork(const int *need, const int *work, int length)
+{
+    for (int j = 0; j < length; j++)
+    {
+        if (need[j] > work[j])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void scalarAddToWork(int *work, const int *allocation, int length)
+{
+    for (int j = 0; j < length; j++)
+    {
+        work[j] += allocation[j];
+    }
+}
+
+static int scalarFirstFitting(const int *needs, int rowStride, const int *finished, int first, int last, const int *work)
+{
+    for (int i = first; i < last; i++)
+    {
+        if (!finished[i] && scalarNeedFitsWork(needs + (size_t)i * rowStride, work, rowStride))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const SafetyKernels scalarKernels = { "scalar", scalarNeedFitsWork, scalarAddToWork, scalarFirstFitting };
+
+#ifdef BANKER_X86
+// SSE2: compara / soma 4 recursos por instrução, com o resto (length % 4) no código escalar
+__attribute__((target("sse2")))
+static inline int sse2NeedFitsWork(const int *need, const int *work, int length)
+{
+    int j = 0;
+    for (; j + 4 <= length; j += 4)
+    {
+        __m128i greater = _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(need + j)), _mm_loadu_si128((const __m128i *)(work + j)));
+        if (_mm_movemask_epi8(greater))
+        {
+            return 0; // Algum recurso da NEED não cabe em work
+        }
+    }
+    return scalarNeedFitsWork(need + j, work + j, length - j);
+}
+
+__attribute__((target("sse2")))
+static void sse2AddToWork(int *work, const int *allocation, int length)
+{
+    int j = 0;
+    for (; j + 4 <= length; j += 4)
+    {
+        __m128i sum = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(work + j)), _mm_loadu_si128((const __m128i *)(allocation + j)));
+        _mm_storeu_si128((__m128i *)(work + j), sum);
+    }
+    scalarAddToWork(work + j, allocation + j, length - j);
+}
+
+// AVX2: 8 recursos por instrução
+__attribute__((target("avx2")))
+static inline int avx2NeedFitsWork(const int *need, const int *work, int length)
+{
+    int j = 0;
+    for (; j + 8 <= length; j += 8)
+    {
+        __m256i greater = _mm256_cmpgt_epi32(_mm256_loadu_si256((const __m256i *)(need + j)), _mm256_loadu_si256((const __m256i *)(work + j)));
+        if (_mm256_movemask_epi8(greater))
+        {
+            return 0;
+        }
+    }
+    return scalarNeedFitsWork(need + j, work + j, length - j);
+}
+
+__attribute__((target("avx2")))
+static void avx2AddToWork(int *work, const int *allocation, int length)
+{
+    int j = 0;
+    for (; j + 8 <= length; j += 8)
+    {
+        __m256i sum = _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(work + j)), _mm256_loadu_si256((const __m256i *)(allocation + j)));
+        _mm256_storeu_si256((__m256i *)(work + j), sum);
+    }
+    scalarAddToWork(work + j, allocation + j, length - j);
+}
+
+// Mesma varredura de scalarFirstFitting, com o teste de cada linha inline
+__attribute__((target("sse2")))
+static int sse2FirstFitting(const int *needs, int rowStride, const int *finished, int first, int last, const int *work)
+{
+    for (int i = first; i < last; i++)
+    {
+        if (!finished[i] && sse2NeedFitsWork(needs + (size_t)i * rowStride, work, rowStride))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+__attribute__((target("avx2")))
+static int avx2FirstFitting(const int *needs, int rowStride, const int *finished, int first, int last, const int *work)
+{
+    for (int i = first; i < last; i++)
+    {
+        if (!finished[i] && avx2NeedFitsWork(needs + (size_t)i * rowStride, work, rowStride))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const SafetyKernels sse2Kernels = { "sse2", sse2NeedFitsWork, sse2AddToWork, sse2FirstFitting };
+const SafetyKernels avx2Kernels = { "avx2", avx2NeedFitsWork, avx2AddToWork, avx2FirstFitting };
+#else
+const SafetyKernels sse2Kernels = { "sse2", scalarNeedFitsWork, scalarAddToWork, scalarFirstFitting };
+const SafetyKernels avx2Kernels = { "avx2", scalarNeedFitsWork, scalarAddToWork, scalarFirstFitting };
+#endif
+
+static const SafetyKernels *activeKernels = NULL; // Kernels usados por checkSafety e pelo motor incremental
+
+// Retorna os kernels pelo nome, ou NULL se não existirem ou a CPU não suportar
+const SafetyKernels* findSafetyKernels(const char *name)
+{
+    if (strcmp(name, "scalar") == 0)
+    {
+        return &scalarKernels;
+    }
+#ifdef BANKER_X86
+    __builtin_cpu_init();
+    if (strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2"))
+    {
+        return &sse2Kernels;
+    }
+    if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2"))
+    {
+        return &avx2Kernels;
+    }
+#endif
+    return NULL;
+}
+
+// Escolhe os melhores kernels suportados pela CPU
+const SafetyKernels* detectSafetyKernels(void)
+{
+    const SafetyKernels *kernels = findSafetyKernels("avx2");
+    if (!kernels)
+    {
+        kernels = findSafetyKernels("sse2");
+    }
+    return kernels ? kernels : &scalarKernels;
+}
+
+void setSafetyKernels(const SafetyKernels *kernels)
+{
+    activeKernels = kernels;
+}
+
+// Escolhe na primeira chamada. Handles da libbanker em threads diferentes podem chegar juntos: todos escolhem os mesmos
+const SafetyKernels* getSafetyKernels(void)
+{
+    const SafetyKernels *kernels = __atomic_load_n(&activeKernels, __ATOMIC_ACQUIRE);
+    if (!kernels)
+    {
+        kernels = detectSafetyKernels();
+        __atomic_store_n(&activeKernels, kernels, __ATOMIC_RELEASE);
+    }
+    return kernels;
+}
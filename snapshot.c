@@ -0,0 +1,180 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "banker.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "O formato binário de checkpoint é little-endian e só é lido/escrito em hosts little-endian"
+#endif
+
+// Formato binário de checkpoint (versão 1), little-endian:
+//   cabeçalho (32 bytes): "BNKC" | versão u16 | reservado u16 | número de clientes u32 | número de recursos u32 |
+//                         número de comandos já executados u64 | bytes de result.txt até esses comandos u64
+//   available (recursos x int32) | demanda máxima (clientes x recursos int32) | alocação (clientes x recursos int32)
+// A NEED não é gravada: é refeita como máximo - alocação na leitura
+#define CHECKPOINT_MAGIC "BNKC"
+#define CHECKPOINT_HEADER_SIZE 32
+
+static int syncParentDirectory(const char *filename);
+
+// Grava o estado e o número de comandos já executados em filename, atomicamente: tudo vai para filename.tmp, que é
+// sincronizado com o disco e renomeado por cima do anterior (quem lê vê o checkpoint velho ou o novo, nunca metade)
+// Depois do rename o diretório também é sincronizado, senão uma queda de energia pode desfazer a troca de nomes
+// outputOffset é o tamanho de result.txt com a saída desses comandos (0 sem saída), onde --restore volta a escrever
+// Retorna 0 se alguma escrita falhou (o checkpoint anterior continua valendo) ou se o diretório não foi sincronizado
+int saveCheckpoint(const char *filename, const BankerState *state, unsigned long long sequence, unsigned long long outputOffset)
+{
+    char temporary[4096];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", filename);
+    OutputWriter *writer = openOutputWriter(temporary);
+    if (!writer)
+    {
+        return 0;
+    }
+
+    int numberOfResources = state->numberOfResources;
+    uint16_t version = CHECKPOINT_VERSION;
+    uint16_t reserved16 = 0;
+    uint32_t customerCount = state->numberOfCustomers;
+    uint32_t resourceCount = numberOfResources;
+    uint64_t commandCount = sequence;
+    uint64_t outputBytes = outputOffset;
+    writerPutBytes(writer, CHECKPOINT_MAGIC, 4);
+    writerPutBytes(writer, (const char *)&version, 2);
+    writerPutBytes(writer, (const char *)&reserved16, 2);
+    writerPutBytes(writer, (const char *)&customerCount, 4);
+    writerPutBytes(writer, (const char *)&resourceCount, 4);
+    writerPutBytes(writer, (const char *)&commandCount, 8);
+    writerPutBytes(writer, (const char *)&outputBytes, 8);
+
+    // As linhas do estado já são int32 contíguos; o padding de cada linha fica de fora
+    size_t rowBytes = numberOfResources * sizeof(int);
+    writerPutBytes(writer, (const char *)state->availableResources, rowBytes);
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        writerPutBytes(writer, (const char *)maximumRow(state, i), rowBytes);
+    }
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        writerPutBytes(writer, (const char *)allocationRow(state, i), rowBytes);
+    }
+
+    flushOutputWriter(writer);
+    int ok = !writer->failed && fsync(writer->fileDescriptor) == 0;
+    ok = closeOutputWriter(writer) && ok;
+    if (!ok || rename(temporary, filename) != 0)
+    {
+        remove(temporary);
+        return 0;
+    }
+    return syncParentDirectory(filename);
+}
+
+// fsync do diretório de filename (o diretório atual se o caminho não tem '/'). Retorna 0 se falhou
+static int syncParentDirectory(const char *filename)
+{
+    char directory[4096];
+    const char *slash = strrchr(filename, '/');
+    if (!slash)
+    {
+        strcpy(directory, ".");
+    }
+    else
+    {
+        size_t length = slash == filename ? 1 : (size_t)(slash - filename); // "/arquivo" fica na raiz
+        if (length >= sizeof(directory))
+        {
+            return 0;
+        }
+        memcpy(directory, filename, length);
+        directory[length] = '\0';
+    }
+
+    int descriptor = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        return 0;
+    }
+    int ok = fsync(descriptor) == 0;
+    return close(descriptor) == 0 && ok;
+}
+
+// Lê um checkpoint (mapeado, copiado linha a linha para um BankerState novo), o número de comandos que ele já inclui e o
+// tamanho de result.txt com a saída deles (outputOffset pode ser NULL)
+// Retorna NULL com o motivo em *error se o arquivo não abre, não é um checkpoint desta versão ou está truncado
+BankerState* loadCheckpoint(const char *filename, unsigned long long *sequence, unsigned long long *outputOffset, const char **error)
+{
+    MappedFile file;
+    if (!mapFile(filename, &file))
+    {
+        *error = "unable to read the file";
+        return NULL;
+    }
+
+    uint16_t version;
+    uint32_t customerCount;
+    uint32_t resourceCount;
+    uint64_t commandCount;
+    uint64_t outputBytes;
+    if (file.size < CHECKPOINT_HEADER_SIZE || memcmp(file.data, CHECKPOINT_MAGIC, 4) != 0)
+    {
+        *error = "not a checkpoint file";
+        unmapFile(&file);
+        return NULL;
+    }
+    memcpy(&version, file.data + 4, 2);
+    memcpy(&customerCount, file.data + 8, 4);
+    memcpy(&resourceCount, file.data + 12, 4);
+    memcpy(&commandCount, file.data + 16, 8);
+    memcpy(&outputBytes, file.data + 24, 8);
+    if (version != CHECKPOINT_VERSION)
+    {
+        *error = "unsupported checkpoint version";
+        unmapFile(&file);
+        return NULL;
+    }
+
+    size_t rowBytes = (size_t)resourceCount * sizeof(int32_t);
+    if (customerCount > INT32_MAX || resourceCount == 0 || resourceCount > INT32_MAX
+        || file.size != CHECKPOINT_HEADER_SIZE + rowBytes * (1 + 2 * (size_t)customerCount))
+    {
+        *error = "truncated or corrupted checkpoint";
+        unmapFile(&file);
+        return NULL;
+    }
+
+    BankerState *state = createBankerState((int)customerCount, (int)resourceCount);
+    if (!state)
+    {
+        *error = "unable to allocate the banker state";
+        unmapFile(&file);
+        return NULL;
+    }
+
+    const char *available = file.data + CHECKPOINT_HEADER_SIZE;
+    const char *maximum = available + rowBytes;
+    const char *allocation = maximum + rowBytes * customerCount;
+    memcpy(state->availableResources, available, rowBytes);
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        int *maximumValues = maximumRow(state, i);
+        int *allocationValues = allocationRow(state, i);
+        int *needValues = needRow(state, i);
+        memcpy(maximumValues, maximum + i * rowBytes, rowBytes);
+        memcpy(allocationValues, allocation + i * rowBytes, rowBytes);
+        for (int j = 0; j < state->numberOfResources; j++)
+        {
+            needValues[j] = maximumValues[j] - allocationValues[j];
+        }
+    }
+
+    unmapFile(&file);
+    *sequence = commandCount;
+    if (outputOffset)
+    {
+        *outputOffset = outputBytes;
+    }
+    return state;
+}
@@ -0,0 +1,115 @@
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+// Cria o estado do banqueiro com as matrizes zeradas, tudo num único bloco alinhado (o BankerState no início)
+BankerState* createBankerState(int numberOfCustomers, int numberOfResources)
+{
+    BankerArena measure = { NULL, 0, 0 };
+    arenaBankerState(&measure, numberOfCustomers, numberOfResources);
+    BankerArena arena = { (char *)allocateArenaBlock(measure.used), measure.used, 0 };
+    if (!arena.base)
+    {
+        return NULL;
+    }
+    return arenaBankerState(&arena, numberOfCustomers, numberOfResources);
+}
+
+// Libera a memória do estado do banqueiro (o bloco de createBankerState)
+void destroyBankerState(BankerState *state)
+{
+    free(state);
+}
+
+// Estado do banqueiro com as matrizes zeradas dentro da arena, cada matriz contígua e alinhada
+// Retorna NULL se a arena não tem espaço (ou só mede: base NULL)
+BankerState* arenaBankerState(BankerArena *arena, int numberOfCustomers, int numberOfResources)
+{
+    int rowStride = bankerRowStride(numberOfResources);
+    size_t matrixBytes = (size_t)numberOfCustomers * rowStride * sizeof(int);
+    BankerState *state = (BankerState *)arenaAllocate(arena, sizeof(BankerState));
+    int *maximumDemand = (int *)arenaAllocate(arena, matrixBytes);
+    int *currentAllocation = (int *)arenaAllocate(arena, matrixBytes);
+    int *remainingNeed = (int *)arenaAllocate(arena, matrixBytes);
+    int *availableResources = (int *)arenaAllocate(arena, rowStride * sizeof(int));
+    if (!state || !maximumDemand || !currentAllocation || !remainingNeed || !availableResources)
+    {
+        return NULL;
+    }
+
+    state->numberOfCustomers = numberOfCustomers;
+    state->numberOfResources = numberOfResources;
+    state->rowStride = rowStride;
+    state->maximumDemand = maximumDemand;
+    state->currentAllocation = currentAllocation;
+    state->remainingNeed = remainingNeed;
+    state->availableResources = availableResources;
+    state->widthKernels = findWidthKernels(numberOfResources); // Com 4, 8 ou 16 recursos, senão NULL (caminho genérico)
+    return state;
+}
+
+// Próximo pedaço de bytes da arena, zerado e alinhado em BANKER_ROW_ALIGNMENT (as linhas de padding também ficam zeradas)
+// Retorna NULL se não cabe; com base NULL só conta os bytes, e used no fim é o tamanho do bloco a alocar
+void* arenaAllocate(BankerArena *arena, size_t bytes)
+{
+    size_t start = (arena->used + BANKER_ROW_ALIGNMENT - 1) / BANKER_ROW_ALIGNMENT * BANKER_ROW_ALIGNMENT;
+    size_t end = start + (bytes + BANKER_ROW_ALIGNMENT - 1) / BANKER_ROW_ALIGNMENT * BANKER_ROW_ALIGNMENT;
+    if (!arena->base)
+    {
+        arena->used = end;
+        return NULL;
+    }
+    if (end > arena->size)
+    {
+        return NULL;
+    }
+
+    arena->used = end;
+    memset(arena->base + start, 0, end - start);
+    return arena->base + start;
+}
+
+// Bloco alinhado para uma arena de size bytes (medida com base NULL), liberado com free
+void* allocateArenaBlock(size_t size)
+{
+    size = (size + BANKER_ROW_ALIGNMENT - 1) / BANKER_ROW_ALIGNMENT * BANKER_ROW_ALIGNMENT; // aligned_alloc exige múltiplo do alinhamento
+    return aligned_alloc(BANKER_ROW_ALIGNMENT, size > 0 ? size : BANKER_ROW_ALIGNMENT);
+}
+
+// Número de ints por linha: numberOfResources arredondado para o múltiplo de BANKER_ROW_PADDING
+// Linhas grandes com tamanho múltiplo de 128 bytes ganham mais BANKER_ROW_PADDING ints, senão a coluna j de todas as linhas
+// cai nos mesmos poucos conjuntos da cache (ex.: 64 recursos = 256 bytes usaria só 1/4 dos conjuntos)
+int bankerRowStride(int numberOfResources)
+{
+    int stride = (numberOfResources + BANKER_ROW_PADDING - 1) / BANKER_ROW_PADDING * BANKER_ROW_PADDING;
+    if (stride * sizeof(int) >= 128 && stride * sizeof(int) % 128 == 0)
+    {
+        stride += BANKER_ROW_PADDING;
+    }
+    return stride;
+}
+
+// 1 se a linha tem algum valor negativo (o padding é zero e não conta)
+int rowHasNegative(const int *row, int length)
+{
+    int negative = 0;
+    for (int j = 0; j < length; j++)
+    {
+        negative |= row[j] < 0;
+    }
+    return negative;
+}
+
+// 1 se algum cliente tem alocação negativa (só acontece com pedidos RQ de valores negativos)
+// Nesse caso terminar um cliente pode diminuir work, e o veredito de checkSafety passa a depender da ordem gulosa dele
+int hasNegativeAllocation(const BankerState *state)
+{
+    for (int i = 0; i < state->numberOfCustomers; i++)
+    {
+        if (rowHasNegative(allocationRow(state, i), state->rowStride))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
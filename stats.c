@@ -0,0 +1,132 @@
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "banker.h"
+
+// Estatísticas de decisões e do caminho quente, ligadas com --stats FILE
+// Só existem com -DBANKER_STATS (make STATS=1); sem a flag os macros STATS_* não geram código e este arquivo fica vazio
+#ifdef BANKER_STATS
+
+BankerStats bankerStats;
+int bankerStatsEnabled;
+volatile sig_atomic_t bankerStatsDumpRequested;
+static const char *statsFilename;
+
+static void handleDumpSignal(int signalNumber);
+static void writeHistogram(FILE *file, const char *name, const long *histogram);
+
+// Liga a coleta e instala o SIGUSR1 (sem SA_RESTART, para o servidor sair do epoll_wait e escrever o arquivo)
+void enableBankerStats(const char *filename)
+{
+    statsFilename = filename;
+    bankerStatsEnabled = 1;
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleDumpSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+}
+
+static void handleDumpSignal(int signalNumber)
+{
+    (void)signalNumber;
+    bankerStatsDumpRequested = 1; // O arquivo é escrito fora do tratador, no próximo STATS_POLL
+}
+
+// Escreve o arquivo pedido por SIGUSR1
+void pollBankerStats(void)
+{
+    bankerStatsDumpRequested = 0;
+    dumpBankerStats();
+}
+
+long statsNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+// Histograma em potências de 2: o bucket 0 conta o zero e o bucket k > 0 conta os valores em [2^(k-1), 2^k)
+void statsRecordHistogram(long *histogram, long value)
+{
+    int bucket = value > 0 ? 64 - __builtin_clzl((unsigned long)value) : 0;
+    if (bucket >= STATS_HISTOGRAM_BUCKETS)
+    {
+        bucket = STATS_HISTOGRAM_BUCKETS - 1;
+    }
+    __atomic_fetch_add(&histogram[bucket], 1, __ATOMIC_RELAXED);
+}
+
+void statsRecordDecision(RequestDecision decision)
+{
+    switch (decision)
+    {
+    case REQUEST_GRANTED:
+        __atomic_fetch_add(&bankerStats.granted, 1, __ATOMIC_RELAXED);
+        break;
+    case REQUEST_EXCEEDS_NEED:
+        __atomic_fetch_add(&bankerStats.deniedExceedsNeed, 1, __ATOMIC_RELAXED);
+        break;
+    case REQUEST_NOT_AVAILABLE:
+        __atomic_fetch_add(&bankerStats.deniedNotAvailable, 1, __ATOMIC_RELAXED);
+        break;
+    case REQUEST_UNSAFE:
+        __atomic_fetch_add(&bankerStats.deniedUnsafe, 1, __ATOMIC_RELAXED);
+        break;
+    }
+}
+
+// Escreve as estatísticas em JSON no arquivo de --stats (num temporário renomeado no fim, então quem lê nunca vê metade)
+// Retorna 0 se não conseguiu escrever
+int dumpBankerStats(void)
+{
+    if (!bankerStatsEnabled || !statsFilename)
+    {
+        return 1;
+    }
+
+    char temporary[4096];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", statsFilename);
+    FILE *file = fopen(temporary, "w");
+    if (!file)
+    {
+        return 0;
+    }
+
+    const BankerStats *stats = &bankerStats;
+    fprintf(file, "{\"requests\":%ld,\"granted\":%ld,", stats->requests, stats->granted);
+    fprintf(file, "\"denied\":{\"exceedsNeed\":%ld,\"notAvailable\":%ld,\"unsafe\":%ld},",
+            stats->deniedExceedsNeed, stats->deniedNotAvailable, stats->deniedUnsafe);
+    fprintf(file, "\"releases\":%ld,\"releasesDenied\":%ld,\"snapshots\":%ld,\"rollbacks\":%ld,\"commitConflicts\":%ld,",
+            stats->releases, stats->releasesDenied, stats->snapshots, stats->rollbacks, stats->commitConflicts);
+    fprintf(file, "\"safetyChecks\":%ld,\"fastApprovals\":%ld,\"cacheHits\":%ld,\"cacheMisses\":%ld,\"checkLatencyTotalNs\":%ld,",
+            stats->safetyChecks, stats->fastApprovals, stats->cacheHits, stats->cacheMisses, stats->checkLatencyTotal);
+    writeHistogram(file, "checkLatencyNs", stats->checkLatency);
+    fprintf(file, ",");
+    writeHistogram(file, "passesPerCheck", stats->checkPasses);
+    fprintf(file, "}\n");
+
+    int ok = fclose(file) == 0;
+    return ok && rename(temporary, statsFilename) == 0;
+}
+
+// Só os buckets não vazios: "limite inferior": contagem
+static void writeHistogram(FILE *file, const char *name, const long *histogram)
+{
+    const char *separator = "";
+    fprintf(file, "\"%s\":{", name);
+    for (int k = 0; k < STATS_HISTOGRAM_BUCKETS; k++)
+    {
+        if (histogram[k] > 0)
+        {
+            fprintf(file, "%s\"%ld\":%ld", separator, k == 0 ? 0L : 1L << (k - 1), histogram[k]);
+            separator = ",";
+        }
+    }
+    fprintf(file, "}");
+}
+
+#endif
@@ -0,0 +1,305 @@
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "banker.h"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "O formato binário de trace é little-endian e só é lido/escrito em hosts little-endian"
+#endif
+
+// Formato binário de trace (versão 1), little-endian:
+//   cabeçalho (16 bytes): "BNKT" | versão u16 | largura dos valores u16 (1 = int8, 2 = int16, 4 = int32) | número de recursos u32 | reservado u32
+//   registros de tamanho fixo: cliente << 2 | opcode (0 = QM, 1 = RQ, 2 = RL, 3 = *) num u32 | um valor por recurso
+//   um CP é um registro de * com TRACE_CHECKPOINT_MARK no lugar do cliente (traces sem CP têm sempre 0 ali)
+//   um QM de todos os clientes tem TRACE_ALL_CUSTOMERS no lugar do cliente, e um QM por recurso tem a direção zerada
+// Os registros de * também carregam os valores (zerados) para todos os registros terem o mesmo tamanho
+#define TRACE_MAGIC "BNKT"
+#define TRACE_HEADER_SIZE 16
+#define TRACE_RECORD_HEADER_SIZE 4
+#define TRACE_ALL_CUSTOMERS 0x3FFFFFFF // QM *
+#define TRACE_MAX_CUSTOMER 0x3FFFFFFE  // O cliente ocupa os 30 bits de cima do u32
+
+static int countResourcesInText(const char *data, size_t size);
+
+// Abre um trace binário e valida o cabeçalho
+int openBinaryTrace(const char *filename, BinaryTrace *trace)
+{
+    memset(trace, 0, sizeof(BinaryTrace));
+    if (!mapFile(filename, &trace->file))
+    {
+        trace->error = "unable to read the file";
+        return 0;
+    }
+
+    const unsigned char *data = (const unsigned char *)trace->file.data;
+    uint16_t version, valueWidth;
+    uint32_t numberOfResources;
+
+    if (trace->file.size < TRACE_HEADER_SIZE || memcmp(data, TRACE_MAGIC, 4) != 0)
+    {
+        trace->error = "not a binary trace";
+        closeBinaryTrace(trace);
+        return 0;
+    }
+    memcpy(&version, data + 4, 2);
+    memcpy(&valueWidth, data + 6, 2);
+    memcpy(&numberOfResources, data + 8, 4);
+
+    if (version != BINARY_TRACE_VERSION)
+    {
+        trace->error = "unsupported trace version";
+        closeBinaryTrace(trace);
+        return 0;
+    }
+    if ((valueWidth != 1 && valueWidth != 2 && valueWidth != 4) || numberOfResources > INT_MAX / 4)
+    {
+        trace->error = "corrupted trace header";
+        closeBinaryTrace(trace);
+        return 0;
+    }
+
+    trace->numberOfResources = (int)numberOfResources;
+    trace->valueWidth = valueWidth;
+    trace->recordSize = TRACE_RECORD_HEADER_SIZE + (size_t)valueWidth * numberOfResources;
+    if ((trace->file.size - TRACE_HEADER_SIZE) % trace->recordSize != 0)
+    {
+        trace->error = "truncated trace";
+        closeBinaryTrace(trace);
+        return 0;
+    }
+    trace->recordCount = (trace->file.size - TRACE_HEADER_SIZE) / trace->recordSize;
+
+    // Registros int8/int16 são convertidos para int neste vetor; os int32 são lidos direto do mapeamento
+    trace->widened = (int *)malloc((numberOfResources + 1) * sizeof(int));
+    if (!trace->widened)
+    {
+        trace->error = "out of memory";
+        closeBinaryTrace(trace);
+        return 0;
+    }
+    return 1;
+}
+
+void closeBinaryTrace(BinaryTrace *trace)
+{
+    unmapFile(&trace->file);
+    free(trace->widened);
+    trace->widened = NULL;
+}
+
+// Lê o próximo registro. Retorna 1 e preenche command ou 0 no fim do trace (todos os opcodes de 2 bits são válidos)
+// O cliente de *, CP e QM de todos os clientes é -1; nos outros é o do registro (não negativo, pode passar do número de clientes)
+// Em registros int32, command->resources aponta direto para o arquivo mapeado (sem cópia)
+int nextTraceRecord(BinaryTrace *trace, Command *command)
+{
+    if (trace->nextRecord >= trace->recordCount)
+    {
+        return 0;
+    }
+
+    const unsigned char *record = (const unsigned char *)trace->file.data + TRACE_HEADER_SIZE + trace->nextRecord * trace->recordSize;
+    const unsigned char *values = record + TRACE_RECORD_HEADER_SIZE;
+    uint32_t word;
+    memcpy(&word, record, 4);
+    trace->nextRecord++;
+
+    switch (word & 3)
+    {
+    case COMMAND_OPCODE_REQUEST:
+        command->type = COMMAND_REQUEST;
+        break;
+    case COMMAND_OPCODE_RELEASE:
+        command->type = COMMAND_RELEASE;
+        break;
+    case COMMAND_OPCODE_SNAPSHOT:
+        command->type = word >> 2 == TRACE_CHECKPOINT_MARK ? COMMAND_CHECKPOINT : COMMAND_PRINT;
+        command->customerID = -1;
+        command->resources = NULL;
+        return 1;
+    default: // COMMAND_OPCODE_QUERY
+        command->type = COMMAND_QUERY;
+        break;
+    }
+
+    command->customerID = word >> 2 == TRACE_ALL_CUSTOMERS && command->type == COMMAND_QUERY ? -1 : (int)(word >> 2);
+
+    if (trace->valueWidth == 4)
+    {
+        // O cabeçalho e os registros têm tamanho múltiplo de 4, então os valores estão alinhados para int
+        command->resources = (int *)(uintptr_t)values;
+    }
+    else if (trace->valueWidth == 1)
+    {
+        for (int j = 0; j < trace->numberOfResources; j++)
+        {
+            trace->widened[j] = (int8_t)values[j];
+        }
+        command->resources = trace->widened;
+    }
+    else
+    {
+        for (int j = 0; j < trace->numberOfResources; j++)
+        {
+            int16_t value;
+            memcpy(&value, values + 2 * j, 2);
+            trace->widened[j] = value;
+        }
+        command->resources = trace->widened;
+    }
+    return 1;
+}
+
+// Converte um commands.txt para o formato binário. Os valores são gravados no menor tipo (int8, int16 ou int32) em que todos cabem
+// Retorna o número de registros gravados, ou -1 em caso de erro (uma linha mal formada é informada com o seu número)
+long convertTextTrace(const char *textFilename, const char *binaryFilename)
+{
+    MappedFile file;
+    if (!mapFile(textFilename, &file))
+    {
+        printf("Fail to read %s\n", textFilename);
+        return -1;
+    }
+
+    int numberOfResources = countResourcesInText(file.data, file.size);
+    if (numberOfResources < 0)
+    {
+        printf("%s: no RQ/RL line to infer the number of resources\n", textFilename);
+        unmapFile(&file);
+        return -1;
+    }
+
+    int resources[numberOfResources + 1];
+    CommandParser parser;
+    Command command;
+    int status;
+    int minimum = 0;
+    int maximum = 0;
+    int maximumCustomer = 0;
+
+    // Primeira passada: valida as linhas e acha a faixa dos valores
+    initCommandParser(&parser, file.data, file.size, INT_MAX, numberOfResources, resources);
+    while ((status = nextCommand(&parser, &command)) > 0)
+    {
+        maximumCustomer = command.customerID > maximumCustomer ? command.customerID : maximumCustomer;
+        for (int j = 0; command.resources && j < numberOfResources; j++)
+        {
+            minimum = command.resources[j] < minimum ? command.resources[j] : minimum;
+            maximum = command.resources[j] > maximum ? command.resources[j] : maximum;
+        }
+    }
+    if (status < 0)
+    {
+        printf("%s:%d: %s\n", textFilename, parser.lineNumber, parser.error);
+        unmapFile(&file);
+        return -1;
+    }
+    if (maximumCustomer > TRACE_MAX_CUSTOMER)
+    {
+        printf("%s: customer number too large for the binary trace\n", textFilename);
+        unmapFile(&file);
+        return -1;
+    }
+
+    OutputWriter *output = openOutputWriter(binaryFilename);
+    if (!output)
+    {
+        printf("Unable to create %s\n", binaryFilename);
+        unmapFile(&file);
+        return -1;
+    }
+
+    // Cabeçalho
+    uint16_t version = BINARY_TRACE_VERSION;
+    uint16_t valueWidth = minimum >= INT8_MIN && maximum <= INT8_MAX ? 1 : minimum >= INT16_MIN && maximum <= INT16_MAX ? 2 : 4;
+    uint32_t resourceCount = numberOfResources;
+    uint32_t reserved = 0;
+    writerPutBytes(output, TRACE_MAGIC, 4);
+    writerPutBytes(output, (const char *)&version, 2);
+    writerPutBytes(output, (const char *)&valueWidth, 2);
+    writerPutBytes(output, (const char *)&resourceCount, 4);
+    writerPutBytes(output, (const char *)&reserved, 4);
+
+    // Segunda passada: um registro por linha
+    unsigned char record[TRACE_RECORD_HEADER_SIZE + 4 * (size_t)numberOfResources];
+    size_t recordSize = TRACE_RECORD_HEADER_SIZE + (size_t)valueWidth * numberOfResources;
+    long records = 0;
+
+    initCommandParser(&parser, file.data, file.size, INT_MAX, numberOfResources, resources);
+    while (nextCommand(&parser, &command) > 0)
+    {
+        uint32_t opcode = command.type == COMMAND_REQUEST ? COMMAND_OPCODE_REQUEST : command.type == COMMAND_RELEASE ? COMMAND_OPCODE_RELEASE
+                          : command.type == COMMAND_QUERY ? COMMAND_OPCODE_QUERY : COMMAND_OPCODE_SNAPSHOT;
+        uint32_t customer = command.type == COMMAND_CHECKPOINT ? TRACE_CHECKPOINT_MARK : command.type == COMMAND_PRINT ? 0
+                            : command.customerID < 0 ? TRACE_ALL_CUSTOMERS : (uint32_t)command.customerID;
+        uint32_t word = customer << 2 | opcode;
+        memset(record, 0, recordSize);
+        memcpy(record, &word, 4);
+
+        for (int j = 0; command.resources && j < numberOfResources; j++)
+        {
+            if (valueWidth == 1)
+            {
+                record[TRACE_RECORD_HEADER_SIZE + j] = (unsigned char)(int8_t)command.resources[j];
+            }
+            else if (valueWidth == 2)
+            {
+                int16_t value = (int16_t)command.resources[j];
+                memcpy(record + TRACE_RECORD_HEADER_SIZE + 2 * j, &value, 2);
+            }
+            else
+            {
+                int32_t value = command.resources[j];
+                memcpy(record + TRACE_RECORD_HEADER_SIZE + 4 * j, &value, 4);
+            }
+        }
+        writerPutBytes(output, (const char *)record, recordSize);
+        records++;
+    }
+
+    unmapFile(&file);
+    if (!closeOutputWriter(output))
+    {
+        printf("Unable to write %s\n", binaryFilename);
+        return -1;
+    }
+    return records;
+}
+
+// Conta os valores de recursos na primeira linha RQ/RL (tokens depois do comando e do cliente), ou -1 se não houver
+static int countResourcesInText(const char *data, size_t size)
+{
+    const char *end = data + size;
+    const char *line = data;
+
+    while (line < end)
+    {
+        const char *lineEnd = (const char *)memchr(line, '\n', end - line);
+        if (!lineEnd)
+        {
+            lineEnd = end;
+        }
+
+        // Brancos no início da linha são pulados, como em nextCommand
+        const char *first = line;
+        while (first < lineEnd && (*first == ' ' || *first == '\t' || *first == '\r'))
+        {
+            first++;
+        }
+
+        int tokens = 0;
+        int inToken = 0;
+        for (const char *p = first; p < lineEnd; p++)
+        {
+            int blank = *p == ' ' || *p == '\t' || *p == '\r';
+            tokens += !blank && !inToken;
+            inToken = !blank;
+        }
+        if (tokens >= 2 && lineEnd - first >= 2 && first[0] == 'R' && (first[1] == 'Q' || first[1] == 'L'))
+        {
+            return tokens - 2;
+        }
+        line = lineEnd + 1;
+    }
+    return -1;
+}
@@ -0,0 +1,155 @@
+#include "banker.h"
+
+// Variantes de checkSafety e da caminhada pela sequência guardada do motor para 4, 8 e 16 recursos
+// Cada variante é a mesma função inline instanciada com a largura constante: o compilador desenrola os laços de recursos
+// e mantém work em registradores, sem a chamada indireta dos kernels de simd.c por linha
+// Só os primeiros numberOfResources ints de cada linha são lidos (o padding é zero e não muda o resultado)
+
+#define WIDTH_MAXIMUM 16 // Maior largura especializada
+
+// 1 se need[j] <= work[j] para todo j; sem desvio por recurso, para o compilador vetorizar
+static inline __attribute__((always_inline)) int fitsWork(const int *need, const int *work, int width)
+{
+    int fits = 1;
+    for (int j = 0; j < width; j++)
+    {
+        fits &= need[j] <= work[j];
+    }
+    return fits;
+}
+
+static inline __attribute__((always_inline)) void addWork(int *work, const int *allocation, int width)
+{
+    for (int j = 0; j < width; j++)
+    {
+        work[j] += allocation[j];
+    }
+}
+
+// checkSafetyOverlay com width recursos: mesmas passadas e mesma sequência segura
+static inline __attribute__((always_inline)) int checkSafetyWidth(const BankerState *state, const SafetyOverlay *overlay, int *safeSequence, int width)
+{
+    int numberOfCustomers = state->numberOfCustomers;
+    int finished[numberOfCustomers];
+    int work[WIDTH_MAXIMUM];
+    int finishedCount = 0;
+
+    for (int j = 0; j < width; j++)
+    {
+        work[j] = overlay->available[j];
+    }
+    for (int i = 0; i < numberOfCustomers; i++)
+    {
+        finished[i] = 0;
+    }
+
+    // Cada passada termina o primeiro cliente que cabe em work; uma passada sem ninguém encerra a checagem
+    for (int k = 0; k < numberOfCustomers; k++)
+    {
+        int found = 0;
+        for (int i = 0; i < numberOfCustomers; i++)
+        {
+            if (!finished[i] && fitsWork(overlayNeedRow(state, overlay, i), work, width))
+            {
+                addWork(work, overlayAllocationRow(state, overlay, i), width);
+                finished[i] = 1;
+                if (safeSequence != NULL)
+                {
+                    safeSequence[k] = i;
+                }
+                found = 1;
+                break;
+            }
+        }
+        if (!found)
+        {
+            break;
+        }
+        finishedCount++;
+    }
+
+    STATS_PASSES(finishedCount + (finishedCount < numberOfCustomers));
+    return finishedCount == numberOfCustomers;
+}
+
+// Termina os clientes de sequence em ordem até o primeiro que não cabe em work. Retorna quantos terminaram
+// work (com rowStride ints) e finished ficam atualizados para o reparo do motor continuar dali
+static inline __attribute__((always_inline)) int walkSequenceWidth(const BankerState *state, const SafetyOverlay *overlay,
+                                                                   const int *sequence, int *work, int *finished, int width)
+{
+    int numberOfCustomers = state->numberOfCustomers;
+    int registers[WIDTH_MAXIMUM];
+    int completed = 0;
+
+    for (int j = 0; j < width; j++)
+    {
+        registers[j] = work[j];
+    }
+    while (completed < numberOfCustomers)
+    {
+        int i = sequence[completed];
+        if (!fitsWork(overlayNeedRow(state, overlay, i), registers, width))
+        {
+            break;
+        }
+        addWork(registers, overlayAllocationRow(state, overlay, i), width);
+        finished[i] = 1;
+        completed++;
+    }
+    for (int j = 0; j < width; j++)
+    {
+        work[j] = registers[j];
+    }
+    return completed;
+}
+
+// Instancia as duas funções de uma largura; TARGET é o atributo de compilação (vazio ou target("avx2"))
+#define DEFINE_WIDTH_KERNELS(NAME, WIDTH, TARGET)                                                                            \
+    TARGET static int checkSafety##NAME(const BankerState *state, const SafetyOverlay *overlay, int *safeSequence)           \
+    {                                                                                                                        \
+        return checkSafetyWidth(state, overlay, safeSequence, WIDTH);                                                        \
+    }                                                                                                                        \
+    TARGET static int walkSequence##NAME(const BankerState *state, const SafetyOverlay *overlay, const int *sequence,        \
+                                         int *work, int *finished)                                                           \
+    {                                                                                                                        \
+        return walkSequenceWidth(state, overlay, sequence, work, finished, WIDTH);                                           \
+    }                                                                                                                        \
+    static const WidthKernels widthKernels##NAME = { WIDTH, checkSafety##NAME, walkSequence##NAME };
+
+DEFINE_WIDTH_KERNELS(4, 4, )
+DEFINE_WIDTH_KERNELS(8, 8, )
+DEFINE_WIDTH_KERNELS(16, 16, )
+#if defined(__x86_64__) || defined(__i386__)
+// Com AVX2 as linhas de 8 e 16 recursos cabem em um e dois registradores
+DEFINE_WIDTH_KERNELS(8Avx2, 8, __attribute__((target("avx2"))))
+DEFINE_WIDTH_KERNELS(16Avx2, 16, __attribute__((target("avx2"))))
+#define WIDTH_AVX2 1
+#endif
+
+// Retorna a variante para numberOfResources recursos, ou NULL se não houver (o caminho genérico é usado)
+const WidthKernels* findWidthKernels(int numberOfResources)
+{
+    int avx2 = 0;
+#ifdef WIDTH_AVX2
+    __builtin_cpu_init();
+    avx2 = __builtin_cpu_supports("avx2");
+#endif
+    switch (numberOfResources)
+    {
+    case 4:
+        return &widthKernels4;
+#ifdef WIDTH_AVX2
+    case 8:
+        return avx2 ? &widthKernels8Avx2 : &widthKernels8;
+    case 16:
+        return avx2 ? &widthKernels16Avx2 : &widthKernels16;
+#else
+    case 8:
+        return &widthKernels8;
+    case 16:
+        return &widthKernels16;
+#endif
+    default:
+        return NULL;
+    }
+}